@@ -25,6 +25,9 @@ namespace CQDataFrame {
 class Scroll;
 class Area;
 class Status;
+class Scheduler;
+class MemoryMgr;
+class ReactiveMgr;
 class TclCmdProc;
 
 class Widget;
@@ -42,7 +45,8 @@ class Frame : public QFrame {
   Q_OBJECT
 
  public:
-  using Vars = std::vector<QVariant>;
+  using Vars    = std::vector<QVariant>;
+  using Widgets = std::vector<Widget *>;
 
  public:
   static QStringList s_completeFile(const QString &file);
@@ -60,6 +64,12 @@ class Frame : public QFrame {
 
   Status *status() const { return status_; }
 
+  Scheduler *scheduler() const { return scheduler_; }
+
+  MemoryMgr *memoryMgr() const { return memoryMgr_; }
+
+  ReactiveMgr *reactiveMgr() const { return reactiveMgr_; }
+
   Area *larea() const;
   Area *rarea() const;
 
@@ -82,6 +92,9 @@ class Frame : public QFrame {
 
   Widget *getWidget(const QString &id) const;
 
+  //! get widgets matching ids or wildcard patterns (single pass over areas)
+  void getWidgets(const QStringList &ids, Widgets &widgets) const;
+
   //--
 
   bool setCmdRc(int rc);
@@ -89,6 +102,7 @@ class Frame : public QFrame {
   bool setCmdRc(const QString &str);
   bool setCmdRc(const QVariant &rc);
   bool setCmdRc(const QStringList &rc);
+  bool setCmdRc(Tcl_Obj *obj);
 
   //---
 
@@ -111,11 +125,14 @@ class Frame : public QFrame {
   using WidgetFactories = std::map<QString, WidgetFactory *>;
 
  private:
-  CQTabSplit* tab_     { nullptr };
-  Scroll*     lscroll_ { nullptr };
-  Scroll*     rscroll_ { nullptr };
-  Status*     status_  { nullptr };
-  CQTcl*      qtcl_    { nullptr };
+  CQTabSplit*  tab_         { nullptr };
+  Scroll*      lscroll_     { nullptr };
+  Scroll*      rscroll_     { nullptr };
+  Status*      status_      { nullptr };
+  Scheduler*   scheduler_   { nullptr };
+  MemoryMgr*   memoryMgr_   { nullptr };
+  ReactiveMgr* reactiveMgr_ { nullptr };
+  CQTcl*       qtcl_        { nullptr };
 
   CQTclCmd::Mgr *mgr_ { nullptr };
 
@@ -153,7 +170,8 @@ class Area : public QFrame {
   Q_OBJECT
 
  public:
-  using Args = std::vector<std::string>;
+  using Args    = std::vector<std::string>;
+  using Widgets = std::vector<Widget *>;
 
  public:
   Area(Scroll *scroll);
@@ -163,6 +181,9 @@ class Area : public QFrame {
 
   Frame *frame() const { return scroll()->frame(); }
 
+  //! get container of placed widgets (translated to scroll)
+  QFrame *contents() const { return contents_; }
+
   const QString &prompt() const { return prompt_; }
   void setPrompt(const QString &s);
 
@@ -187,11 +208,17 @@ class Area : public QFrame {
 
   Widget *getWidget(const QString &id) const;
 
+  const Widgets &widgets() const { return widgets_; }
+
   //---
 
   int xOffset() const;
   int yOffset() const;
 
+  void scrollContents();
+
+  void schedulePlaceWidgets();
+
   void placeWidgets();
 
   //---
@@ -208,9 +235,8 @@ class Area : public QFrame {
   bool event(QEvent *event) override;
 
  private:
-  using Widgets = std::vector<Widget *>;
-
   Scroll*        scroll_       { nullptr };
+  QFrame*        contents_     { nullptr };
   QString        prompt_       { "> " };
   Widgets        widgets_;
   CommandWidget* command_      { nullptr };
@@ -282,6 +308,14 @@ CQDATA_FRAME_TCL_CMD(Complete)
 CQDATA_FRAME_TCL_CMD(GetData)
 CQDATA_FRAME_TCL_CMD(SetData)
 
+//---
+
+CQDATA_FRAME_TCL_CMD(Vector)
+
+//---
+
+CQDATA_FRAME_TCL_CMD(Profile)
+
 }
 
 #endif
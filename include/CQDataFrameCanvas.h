@@ -5,12 +5,171 @@
 #include <CQDataFrameWidget.h>
 #include <CDisplayRange2D.h>
 
+#include <QPen>
+#include <QBrush>
+#include <QPainterPath>
+
+#include <vector>
+#include <algorithm>
+
 namespace CQDataFrame {
 
 CQDATA_FRAME_TCL_CMD(Canvas)
 
 CQDATA_FRAME_INST_TCL_CMD(Canvas)
 
+// retained canvas primitives
+//
+// Pens, brushes, paths (window coords) and bulk points (window or pixel coords) recorded
+// from the canvas draw proc. The list is replayed for any pixel range or window range
+// so the draw proc is only rerun when the canvas is invalidated.
+class CanvasDisplayList {
+ public:
+  using DisplayRange = CDisplayRange2D;
+  using Points       = std::vector<QPointF>;
+  using Colors       = std::vector<QColor>;
+  using Paths        = std::vector<QPainterPath>;
+
+  //! marker symbol
+  enum class Symbol {
+    CIRCLE,
+    SQUARE,
+    CROSS,
+    PLUS
+  };
+
+ public:
+  CanvasDisplayList() { }
+
+  //! get/set is valid (recorded)
+  bool isValid() const { return valid_; }
+  void setValid(bool b) { valid_ = b; }
+
+  bool isEmpty() const { return items_.empty(); }
+
+  //! get number of items
+  int size() const { return int(items_.size()); }
+
+  //! get approximate memory used (bytes)
+  qint64 bytes() const;
+
+  //! remove all items (list invalid)
+  void clear();
+
+  void setPen  (const QPen &pen);
+  void setBrush(const QBrush &brush);
+
+  //! add path (window coords)
+  void addPath(const QPainterPath &path);
+
+  //! add pixel (window coords if mapped, else pixel coords)
+  void addPixel(const QPointF &p, bool mapped);
+
+  //! add points drawn with pen (optional color per point)
+  void addPoints(const Points &points, const Colors &colors, bool mapped);
+
+  //! add polyline through points
+  void addPolyline(const Points &points, bool mapped);
+
+  //! add rectangles (corner point pairs, optional fill color per rectangle)
+  void addRects(const Points &points, const Colors &colors, bool mapped);
+
+  //! add markers of pixel size at points (optional fill color per marker)
+  void addMarkers(const Points &points, const Colors &colors, Symbol symbol,
+                  double size, bool mapped);
+
+  //! draw items to painter using display range for window to pixel mapping
+  //! (display range unused if list is in pixel coords)
+  void draw(QPainter *painter, const DisplayRange &displayRange) const;
+
+  //! is list in pixel coords (see mapToPixels)
+  bool isPixelCoords() const { return pixelCoords_; }
+
+  //! get copy of list with all coords mapped to pixels (shared by tile painters)
+  void mapToPixels(const DisplayRange &displayRange, CanvasDisplayList &pixelList) const;
+
+  //! items (and primitives of bulk items) of pixel coords list overlapping tile
+  struct TileBin {
+    struct Entry {
+      int              item { -1 }; //!< item index
+      std::vector<int> prims;       //!< primitives in tile (empty for whole item)
+    };
+
+    std::vector<Entry> entries;
+  };
+
+  using TileBins = std::vector<TileBin>;
+
+  //! bin pixel coords list into nx by ny grid of tiles by pixel bounding box
+  void binTiles(int tileSize, int nx, int ny, TileBins &bins) const;
+
+  //! draw items of tile bin (paths are drawn from caller's copies as shared
+  //! path data has lazily built caches so can't be drawn from several threads)
+  void drawBin(QPainter *painter, const TileBin &bin, Paths &paths) const;
+
+ private:
+  enum class Type {
+    PEN,
+    BRUSH,
+    PATH,
+    PIXELS,
+    POINTS,
+    POLYLINE,
+    RECTS,
+    MARKERS
+  };
+
+  struct Item {
+    Type   type     { Type::PATH };
+    int    ind      { -1 };             //!< index into pens, brushes, paths or points
+    int    colorInd { -1 };             //!< index into colors (-1 if none)
+    bool   mapped   { true };           //!< points in window coords
+    Symbol symbol   { Symbol::CIRCLE }; //!< marker symbol
+    double size     { 0.0 };            //!< marker size (pixels)
+  };
+
+  using Items      = std::vector<Item>;
+  using Pens       = std::vector<QPen>;
+  using Brushes    = std::vector<QBrush>;
+  using PointsList = std::vector<Points>;
+  using ColorsList = std::vector<Colors>;
+
+  Item &addPointsItem(Type type, const Points &points, const Colors &colors, int n,
+                      bool mapped);
+
+  //! get pixel points of item (mapped into buffer if in window coords)
+  const QPointF *mapPoints(const Item &item, const DisplayRange &displayRange,
+                           Points &buffer) const;
+
+  //! get points and colors (if any) of binned primitives of item
+  const Colors *binPoints(const Item &item, const std::vector<int> &prims,
+                          Points &points, Colors &colors) const;
+
+  void drawPoints (QPainter *painter, const Item &item, int n, const QPointF *ppoints,
+                   const Colors *colors) const;
+  void drawRects  (QPainter *painter, const Item &item, int n, const QPointF *ppoints,
+                   const Colors *colors) const;
+  void drawMarkers(QPainter *painter, const Item &item, int n, const QPointF *ppoints,
+                   const Colors *colors) const;
+
+  //! get number of primitives of item
+  int numPrimitives(const Item &item) const;
+
+  //! get colors of item primitives (null if none)
+  const Colors *itemColors(const Item &item) const;
+
+  Items      items_;
+  Pens       pens_;
+  Brushes    brushes_;
+  Paths      paths_;
+  PointsList points_;
+  ColorsList colors_;
+  bool       valid_       { false };
+  bool       pixelCoords_ { false };
+};
+
+//---
+
 // canvas
 class CanvasWidget : public Widget {
   Q_OBJECT
@@ -32,7 +191,13 @@ class CanvasWidget : public Widget {
 
   //! get/set draw proc
   const QString &drawProc() const { return drawProc_; }
-  void setDrawProc(const QString &s) { drawProc_ = s; }
+  void setDrawProc(const QString &s);
+
+  //! get retained display list
+  const CanvasDisplayList &displayList() const { return displayList_; }
+
+  //! invalidate display list (draw proc rerun on next draw)
+  void invalidate();
 
   //! get/set xmin
   double xmin() const { return xmin_; }
@@ -50,9 +215,19 @@ class CanvasWidget : public Widget {
   double ymax() const { return ymax_; }
   void setYMax(double r) { ymax_ = r; }
 
+  //! get/set number of threads rendering image tiles (0 is number of cores, default)
+  int numThreads() const { return numThreads_; }
+  void setNumThreads(int n) { numThreads_ = std::max(n, 0); }
+
   QSize contentsSizeHint() const override;
   QSize contentsSize() const override;
 
+  void addMenuItems(QMenu *menu) override;
+
+  qint64 payloadBytes() const override;
+
+  bool writePayload(QDataStream &os) const override;
+
   void setBrush(const QBrush &brush);
 
   void setPen(const QPen &pen);
@@ -61,32 +236,60 @@ class CanvasWidget : public Widget {
 
   void drawPixel(const QPointF &p);
 
+  using Points = CanvasDisplayList::Points;
+  using Colors = CanvasDisplayList::Colors;
+  using Symbol = CanvasDisplayList::Symbol;
+
+  //! draw bulk primitives (window coords if mapping, else pixel coords)
+  void drawPoints  (const Points &points, const Colors &colors);
+  void drawPolyline(const Points &points);
+  void drawRects   (const Points &points, const Colors &colors);
+  void drawMarkers (const Points &points, const Colors &colors, Symbol symbol, double size);
+
   bool isMapping() const { return mapping_; }
   void setMapping(bool b) { mapping_ = b; }
 
   void windowToPixel(double wx, double wy, double *px, double *py) const;
   void pixelToWindow(double px, double py, double *wx, double *wy) const;
 
+ private Q_SLOTS:
+  void redrawSlot();
+
  private:
   void updateSize();
 
+  void recordDisplayList();
+
+  void renderImage();
+
+  void invalidatePixelList();
+
   void setWindowRange();
 
+  void freePayload() override;
+  bool readPayload(QDataStream &is) override;
+
   void draw(QPainter *painter, int dx, int dy) override;
 
  private:
   using DisplayRange = CDisplayRange2D;
-
-  QString      drawProc_;
-  DisplayRange displayRange_;
-  QImage       image_;
-  QPainter*    ipainter_ { nullptr };
-  bool         dirty_    { true };
-  double       xmin_     { 0.0 };
-  double       ymin_     { 0.0 };
-  double       xmax_     { 100.0 };
-  double       ymax_     { 100.0 };
-  bool         mapping_  { true };
+  using TileBins     = CanvasDisplayList::TileBins;
+
+  QString           drawProc_;
+  DisplayRange      displayRange_;
+  CanvasDisplayList displayList_;
+  CanvasDisplayList pixelList_;                  //!< display list mapped to pixels (for tiles)
+  TileBins          tileBins_;                   //!< pixel list items per tile
+  QImage            image_;
+  bool              pixelListValid_ { false };
+  bool              recording_      { false };
+  bool              dirty_          { true };
+  double            xmin_           { 0.0 };
+  double            ymin_           { 0.0 };
+  double            xmax_           { 100.0 };
+  double            ymax_           { 100.0 };
+  bool              mapping_        { true };
+  int               numThreads_     { 0 };
 };
 
 class CanvasFactory : public WidgetFactory {
@@ -2,6 +2,7 @@
 #define CQDataFrameCommand_H
 
 #include <CQDataFrameWidget.h>
+#include <CTclIncrParse.h>
 
 namespace CQDataFrame {
 
@@ -35,7 +36,15 @@ class CommandWidget : public Widget {
     }
 
     const QString &getText() const { return text_; }
-    void setText(const QString &text) { text_ = text; pos_ = 0; }
+
+    void setText(const QString &text) {
+      replaceParse(0, text_.length(), text);
+
+      text_ = text; pos_ = 0;
+    }
+
+    //! set parse updated by edits (entry text starts at offset in parsed text)
+    void setParse(CTclIncrParse *parse, int offset) { parse_ = parse; parseOffset_ = offset; }
 
     int getPos() const { return pos_; }
 
@@ -55,6 +64,8 @@ class CommandWidget : public Widget {
     }
 
     void insert(const QString &str) {
+      replaceParse(pos_, 0, str);
+
       auto lhs = text_.mid(0, pos_);
       auto rhs = text_.mid(pos_);
 
@@ -65,6 +76,8 @@ class CommandWidget : public Widget {
 
     void backSpace() {
       if (pos_ > 0) {
+        replaceParse(pos_ - 1, 1, "");
+
          auto lhs = text_.mid(0, pos_);
          auto rhs = text_.mid(pos_);
 
@@ -76,6 +89,8 @@ class CommandWidget : public Widget {
 
     void deleteChar() {
       if (pos_ < text_.length()) {
+        replaceParse(pos_, 1, "");
+
         auto lhs = text_.mid(0, pos_);
         auto rhs = text_.mid(pos_);
 
@@ -84,8 +99,17 @@ class CommandWidget : public Widget {
     }
 
    private:
-    QString text_;
-    int     pos_ { 0 };
+    void replaceParse(int pos, int len, const QString &str) {
+      // parsed text is Latin-1 (one char per QChar so positions match)
+      if (parse_)
+        parse_->replace(parseOffset_ + pos, len, str.toLatin1().toStdString());
+    }
+
+   private:
+    QString        text_;
+    int            pos_         { 0 };
+    CTclIncrParse* parse_       { nullptr }; //!< parse of widget text (if any)
+    int            parseOffset_ { 0 };       //!< entry text start in parsed text
   };
 
   //---
@@ -118,6 +142,8 @@ class CommandWidget : public Widget {
 
   void clearText();
 
+  void resetParse();
+
   //---
 
   void mousePressEvent  (QMouseEvent *e) override;
@@ -126,6 +152,12 @@ class CommandWidget : public Widget {
 
   bool pixelToText(const QPoint &p, int &lineNum, int &charNum);
 
+  QRect lineRect(int lineNum) const override;
+
+  bool hasSelection() const;
+
+  void updateEntry(const QString &oldText, int oldPos);
+
   //---
 
   bool event(QEvent *e) override;
@@ -152,13 +184,15 @@ class CommandWidget : public Widget {
   QString selectedText() const;
 
  private:
-  Entry       entry_;
-  QStringList commands_;
-  int         commandNum_   { -1 };
-  QColor      cursorColor_  { 60, 217, 60 };
-  QColor      selColor_     { 217, 217, 8 };
-  int         promptY_      { 0 };
-  int         promptWidth_  { 0 };
+  Entry         entry_;
+  mutable CTclIncrParse incrParse_;            //!< incremental parse of text (entry edits)
+  QStringList   commands_;
+  int           commandNum_   { -1 };
+  QColor        cursorColor_  { 60, 217, 60 };
+  QColor        selColor_     { 217, 217, 8 };
+  int           promptX_      { 0 }; //!< drawn prompt x (including scroll offset)
+  int           promptY_      { 0 };
+  int           promptWidth_  { 0 };
 };
 
 }
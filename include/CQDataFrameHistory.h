@@ -21,6 +21,8 @@ class HistoryWidget : public Widget {
   QSize contentsSizeHint() const override;
   QSize contentsSize() const override;
 
+  bool canCache() const override { return true; }
+
   QSize calcSize(int maxLines) const;
 
  private:
@@ -42,6 +42,12 @@ class ImageWidget : public Widget {
   QSize contentsSizeHint() const override;
   QSize contentsSize() const override;
 
+  bool canCache() const override { return true; }
+
+  qint64 payloadBytes() const override;
+
+  bool writePayload(QDataStream &os) const override;
+
  private Q_SLOTS:
   void zoomInSlot();
   void zoomOutSlot();
@@ -50,6 +56,9 @@ class ImageWidget : public Widget {
  private:
   void updateImage();
 
+  void freePayload() override;
+  bool readPayload(QDataStream &is) override;
+
   void draw(QPainter *painter, int dx, int dy) override;
 
  private:
@@ -0,0 +1,108 @@
+#ifndef CQDataFrameMemoryMgr_H
+#define CQDataFrameMemoryMgr_H
+
+#include <QObject>
+#include <QPointer>
+#include <map>
+#include <vector>
+
+class QTemporaryFile;
+class QTimer;
+
+namespace CQDataFrame {
+
+class Frame;
+class Widget;
+
+// session memory budget for cell payloads (text, images, ...)
+// least recently viewed cells over budget are written to a spill file and their
+// payload released until they are next viewed or queried
+class MemoryMgr : public QObject {
+  Q_OBJECT
+
+ public:
+  MemoryMgr(Frame *frame);
+ ~MemoryMgr();
+
+  Frame *frame() const { return frame_; }
+
+  //! get/set memory budget (bytes)
+  qint64 maxBytes() const { return maxBytes_; }
+  void setMaxBytes(qint64 n);
+
+  //! get memory used by in memory payloads (bytes)
+  qint64 usedBytes() const;
+
+  //---
+
+  //! add/remove widget (removed widget payload is restored)
+  void addWidget   (Widget *widget);
+  void removeWidget(Widget *widget);
+
+  //! mark widget as viewed (restore payload if spilled)
+  void touch(Widget *widget);
+
+  //! restore spilled widget payload
+  bool restore(Widget *widget);
+
+  //! check budget on next event loop turn
+  void scheduleCheck();
+
+  //! spill least recently viewed widget payloads until under budget
+  void checkBudget();
+
+  //---
+
+  //! get number of spilled widgets
+  int numSpilled() const;
+
+  //! get number of spill/restore operations
+  int numSpills  () const { return numSpills_  ; }
+  int numRestores() const { return numRestores_; }
+
+ private:
+  bool spill(Widget *widget);
+
+  bool openFile();
+
+  //! get spill file offset for payload of size (reuses freed ranges)
+  qint64 allocRange(qint64 size);
+
+  //! free spill file range (merged with adjacent free ranges)
+  void freeRange(qint64 offset, qint64 size);
+
+ private Q_SLOTS:
+  void timerSlot();
+
+ private:
+  struct WidgetData {
+    QPointer<Widget> widget;
+    qint64           lastViewed { 0 };  //!< view counter when last viewed
+    bool             spilled    { false };
+    qint64           offset     { 0 };  //!< spill file offset
+    qint64           size       { 0 };  //!< spill file size
+  };
+
+  using WidgetDatas = std::map<Widget *, WidgetData>;
+
+  struct Range {
+    qint64 offset { 0 };
+    qint64 size   { 0 };
+  };
+
+  using Ranges = std::vector<Range>;
+
+  Frame*          frame_       { nullptr };
+  QTimer*         timer_       { nullptr };
+  QTemporaryFile* file_        { nullptr };
+  WidgetDatas     widgetDatas_;
+  Ranges          freeRanges_;                //!< unused spill file ranges (sorted)
+  qint64          maxBytes_    { 256*1024*1024 };
+  qint64          viewCount_   { 0 };
+  int             numSpills_   { 0 };
+  int             numRestores_ { 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef CQDataFrameRasterCache_H
+#define CQDataFrameRasterCache_H
+
+#include <QtGlobal>
+#include <list>
+
+namespace CQDataFrame {
+
+class WidgetContents;
+
+// global budget and LRU order for per cell backing pixmaps
+// (pixmaps are owned by the widget contents, the cache only tracks them)
+class RasterCache {
+ public:
+  static RasterCache *instance();
+
+ ~RasterCache() { }
+
+  //! get/set enabled
+  bool isEnabled() const { return enabled_; }
+  void setEnabled(bool b);
+
+  //! get/set memory budget (bytes)
+  qint64 maxBytes() const { return maxBytes_; }
+  void setMaxBytes(qint64 n);
+
+  //! get memory used by cached pixmaps (bytes)
+  qint64 usedBytes() const { return usedBytes_; }
+
+  //! add/update contents pixmap (most recently used) and evict to budget
+  void add(WidgetContents *contents, qint64 bytes);
+
+  //! mark contents pixmap as most recently used
+  void touch(WidgetContents *contents);
+
+  //! remove contents (pixmap released by caller)
+  void remove(WidgetContents *contents);
+
+  //! release all pixmaps
+  void clear();
+
+ private:
+  RasterCache() { }
+
+  void evict();
+
+ private:
+  struct Entry {
+    WidgetContents* contents { nullptr };
+    qint64          bytes    { 0 };
+
+    Entry(WidgetContents *contents, qint64 bytes) :
+     contents(contents), bytes(bytes) {
+    }
+  };
+
+  using Entries = std::list<Entry>;
+
+  bool    enabled_   { true };
+  qint64  maxBytes_  { 128*1024*1024 };
+  qint64  usedBytes_ { 0 };
+  Entries entries_; //!< front is most recently used
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef CQDataFrameReactiveMgr_H
+#define CQDataFrameReactiveMgr_H
+
+#include <QObject>
+#include <QPointer>
+#include <map>
+#include <set>
+#include <vector>
+
+class QTimer;
+
+namespace CQDataFrame {
+
+class Frame;
+class TclWidget;
+
+// dependencies of reactive tcl cells on global variables
+// global variable reads are recorded while a reactive cell runs and cells which
+// read a variable are rerun (debounced, in dependency order) when it is written.
+// All globals are traced around each run and traces are removed when the last
+// reactive widget is removed
+class ReactiveMgr : public QObject {
+  Q_OBJECT
+
+ public:
+  ReactiveMgr(Frame *frame);
+
+  Frame *frame() const { return frame_; }
+
+  //! get/set rerun delay (ms)
+  int delay() const;
+  void setDelay(int ms);
+
+  //---
+
+  //! add/remove reactive widget
+  void addWidget   (TclWidget *widget);
+  void removeWidget(TclWidget *widget);
+
+  //! start/end recording variables used by widget command
+  void startRun(TclWidget *widget);
+  void endRun  (TclWidget *widget);
+
+  //! get variables read/written by widget last run
+  QStringList readVars (TclWidget *widget) const;
+  QStringList writeVars(TclWidget *widget) const;
+
+  //! get number of reruns
+  int numReruns() const { return numReruns_; }
+
+ private:
+  using Names = std::set<QString>;
+
+  struct WidgetData {
+    QPointer<TclWidget> widget;
+    Names               reads;  //!< globals read in last run
+    Names               writes; //!< globals written in last run
+  };
+
+  using WidgetDatas = std::map<TclWidget *, WidgetData>;
+  using Widgets     = std::vector<TclWidget *>;
+  using WidgetSet   = std::set<TclWidget *>;
+
+ private:
+  void traceGlobals();
+
+  void untraceGlobals();
+
+  void sortWidgets(const WidgetSet &widgets, Widgets &sorted) const;
+
+ private Q_SLOTS:
+  void varReadSlot   (const QString &name);
+  void varWrittenSlot(const QString &name);
+
+  void timerSlot();
+
+ private:
+  Frame*      frame_     { nullptr };
+  QTimer*     timer_     { nullptr };
+  WidgetDatas widgetDatas_;
+  Widgets     running_;             //!< widgets being run (nested)
+  WidgetSet   dirty_;               //!< widgets to rerun
+  WidgetSet   batch_;               //!< widgets in current rerun batch
+  Names       traced_;              //!< globals traced by manager
+  int         numReruns_ { 0 };
+};
+
+}
+
+#endif
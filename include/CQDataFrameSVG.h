@@ -27,6 +27,8 @@ class SVGWidget : public Widget {
   QSize contentsSizeHint() const override;
   QSize contentsSize() const override;
 
+  bool canCache() const override { return true; }
+
  private:
   void draw(QPainter *painter, int dx, int dy) override;
 
@@ -0,0 +1,82 @@
+#ifndef CQDataFrameScheduler_H
+#define CQDataFrameScheduler_H
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <vector>
+
+class QTimer;
+
+namespace CQDataFrame {
+
+class Frame;
+class Area;
+
+// collects layout (place widgets) and repaint requests and processes them
+// at most once per event loop turn
+class Scheduler : public QObject {
+  Q_OBJECT
+
+ public:
+  Scheduler(Frame *frame);
+
+  Frame *frame() const { return frame_; }
+
+  //---
+
+  //! request widget placement for area
+  void requestLayout(Area *area);
+
+  //! request repaint of widget
+  void requestUpdate(QWidget *widget);
+
+  //! notify layout pass started for area (removes any pending request)
+  void startLayout(Area *area);
+
+  //! run pending layout for area now
+  void flushLayout(Area *area);
+
+  bool isLayoutPending(Area *area) const;
+
+  //---
+
+  //! get number of layout passes run
+  int numLayouts() const { return numLayouts_; }
+
+  //! get number of layout requests merged into an already pending pass
+  int numSkipped() const { return numSkipped_; }
+
+  //! get number of widget repaints run
+  int numUpdates() const { return numUpdates_; }
+
+  //! get number of repaint requests merged into an already pending repaint
+  int numUpdatesSkipped() const { return numUpdatesSkipped_; }
+
+  void resetStats() {
+    numLayouts_ = 0; numSkipped_ = 0; numUpdates_ = 0; numUpdatesSkipped_ = 0;
+  }
+
+ private:
+  void startTimer();
+
+ private Q_SLOTS:
+  void timerSlot();
+
+ private:
+  using Areas   = std::vector<Area *>;
+  using Widgets = std::vector<QPointer<QWidget>>;
+
+  Frame*  frame_             { nullptr };
+  QTimer* timer_             { nullptr };
+  Areas   areas_;
+  Widgets widgets_;
+  int     numLayouts_        { 0 };
+  int     numSkipped_        { 0 };
+  int     numUpdates_        { 0 };
+  int     numUpdatesSkipped_ { 0 };
+};
+
+}
+
+#endif
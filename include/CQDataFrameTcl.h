@@ -12,7 +12,8 @@ namespace CQDataFrame {
 class TclWidget : public TextWidget {
   Q_OBJECT
 
-  Q_PROPERTY(QString command READ cmd WRITE setCmd)
+  Q_PROPERTY(QString command  READ cmd        WRITE setCmd     )
+  Q_PROPERTY(bool    reactive READ isReactive WRITE setReactive)
 
  public:
   TclWidget(Area *area, const QString &cmd, bool expr, const QString &res);
@@ -27,6 +28,17 @@ class TclWidget : public TextWidget {
   const QString &cmd() const { return cmd_; }
   void setCmd(const QString &s);
 
+  //! get/set reactive (rerun when global variables read by command are written)
+  bool isReactive() const { return reactive_; }
+  void setReactive(bool b);
+
+  //! rerun command
+  void rerun();
+
+  //! get/set name value
+  bool getNameValue(const QString &name, QVariant &value) const override;
+  bool setNameValue(const QString &name, const QVariant &value) override;
+
   void addMenuItems(QMenu *menu) override;
 
   QSize contentsSizeHint() const override;
@@ -42,12 +54,15 @@ class TclWidget : public TextWidget {
 
   void rerunSlot();
 
+  void reactiveSlot(bool b);
+
  private:
-  void draw(QPainter *painter, int dx, int dy) override;
+  void resizeEvent(QResizeEvent *e) override;
 
  private:
   QString       cmd_;
   bool          expr_      { false };
+  bool          reactive_  { false };
   QTextEdit*    edit_      { nullptr };
   CQIconButton* runButton_ { nullptr };
 };
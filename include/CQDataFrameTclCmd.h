@@ -15,7 +15,8 @@ class NAME##TclCmd : public CQTclCmd::CmdProc { \
     Real    = int(CQTclCmd::CmdArg::Type::Real), \
     String  = int(CQTclCmd::CmdArg::Type::String), \
     SBool   = int(CQTclCmd::CmdArg::Type::SBool), \
-    Enum    = int(CQTclCmd::CmdArg::Type::Enum) \
+    Enum    = int(CQTclCmd::CmdArg::Type::Enum), \
+    Object  = int(CQTclCmd::CmdArg::Type::Object) \
   }; \
 \
   using CmdArg = CQTclCmd::CmdArg; \
@@ -54,7 +55,8 @@ class NAME##InstTclCmd : public CQTclCmd::CmdProc { \
     Real    = int(CQTclCmd::CmdArg::Type::Real), \
     String  = int(CQTclCmd::CmdArg::Type::String), \
     SBool   = int(CQTclCmd::CmdArg::Type::SBool), \
-    Enum    = int(CQTclCmd::CmdArg::Type::Enum) \
+    Enum    = int(CQTclCmd::CmdArg::Type::Enum), \
+    Object  = int(CQTclCmd::CmdArg::Type::Object) \
   }; \
 \
   using CmdArg = CQTclCmd::CmdArg; \
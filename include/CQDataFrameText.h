@@ -26,13 +26,22 @@ class TextWidget : public Widget {
   QSize contentsSizeHint() const override;
   QSize contentsSize() const override;
 
+  bool canCache() const override { return true; }
+
+  qint64 payloadBytes() const override;
+
+  bool writePayload(QDataStream &os) const override;
+
   QSize textSize(const QString &text, int maxLines=-1) const;
 
   //! get/set is error
   bool isError() const { return isError_; }
-  void setIsError(bool b) { isError_ = b; }
+  void setIsError(bool b) { isError_ = b; invalidateCache(); }
 
  protected:
+  void freePayload() override;
+  bool readPayload(QDataStream &is) override;
+
   void updateLines();
 
   void calcLines(LineList &lines, const QString &text) const;
@@ -48,6 +48,8 @@ class UnixWidget : public TextWidget {
   void rerunSlot();
 
  private:
+  void resizeEvent(QResizeEvent *e) override;
+
   void draw(QPainter *painter, int dx, int dy) override;
 
  private:
@@ -3,11 +3,13 @@
 
 #include <CQScrollArea.h>
 #include <QFrame>
+#include <QPixmap>
 
 class CQTcl;
 
 class QMenu;
 class QTextStream;
+class QDataStream;
 
 namespace CQDataFrame {
 
@@ -118,6 +120,15 @@ class Widget : public QFrame {
 
   bool pixelToText(const QPoint &p, int &lineNum, int &charNum);
 
+  //! is text selection in progress
+  bool isSelecting() const { return mouseData_.pressed; }
+
+  //! get contents rect of text line (invalid if not drawn)
+  virtual QRect lineRect(int lineNum) const;
+
+  //! repaint contents area of text lines
+  void updateLineRange(int lineNum1, int lineNum2);
+
   void drawContents(QPainter *painter);
 
 //void resizeContents(int w, int h);
@@ -127,15 +138,62 @@ class Widget : public QFrame {
 
   QSize sizeHint() const override;
 
+  //---
+
+  //! can contents be drawn from cached pixmap
+  virtual bool canCache() const { return false; }
+
+  //! get contents version (changed when drawn contents change)
+  int contentsVersion() const { return contentsVersion_; }
+
+  //! invalidate cached contents pixmap
+  void invalidateCache() { ++contentsVersion_; }
+
+  //! request repaint of widget (merged with other requests by frame scheduler)
+  void scheduleUpdate();
+
+  //! get contents scroll offset
+  QPoint contentsOffset() const;
+
+  //---
+
+  //! get in memory payload size (bytes) for session memory budget
+  virtual qint64 payloadBytes() const { return 0; }
+
+  //! write payload to stream (for spill file)
+  virtual bool writePayload(QDataStream &) const { return false; }
+
+  //! is payload spilled (released from memory)
+  bool isSpilled() const { return spilled_; }
+
+  //! release payload (after written to spill file)
+  void releasePayload();
+
+  //! restore payload from stream
+  bool restorePayload(QDataStream &is);
+
+  //! ensure payload in memory (restore if spilled)
+  void loadPayload() const;
+
+  //! get contents size hint/size saved when spilled
+  const QSize &spillSizeHint() const { return spillSizeHint_; }
+  const QSize &spillSize    () const { return spillSize_    ; }
+
  protected:
   void setFixedFont();
 
+  //! free/read payload (spill support)
+  virtual void freePayload() { }
+  virtual bool readPayload(QDataStream &) { return false; }
+
  Q_SIGNALS:
   void contentsChanged();
 
  protected Q_SLOTS:
   void contentsUpdateSlot();
 
+  void contentsChangedSlot();
+
   void setExpandedSlot(bool b) { setExpanded(b); }
 
   virtual void setEditing(bool b);
@@ -281,6 +339,10 @@ class Widget : public QFrame {
   int         height_         { -1 };
   LineList    lines_;
   MouseData   mouseData_;
+  int         contentsVersion_ { 0 };
+  bool        spilled_         { false };
+  QSize       spillSizeHint_;
+  QSize       spillSize_;
 };
 
 //---
@@ -290,6 +352,7 @@ class WidgetContents : public QFrame {
 
  public:
   WidgetContents(Widget *widget);
+ ~WidgetContents();
 
   //---
 
@@ -307,8 +370,20 @@ class WidgetContents : public QFrame {
 
   QSize contentsSize() const;
 
+  //---
+
+  //! release cached contents pixmap
+  void releaseCache();
+
+ private:
+  void updateCache();
+
  private:
-  Widget* widget_ { nullptr };
+  Widget* widget_       { nullptr };
+  QPixmap cache_;                    //!< cached contents pixmap
+  int     cacheVersion_ { -1 };      //!< contents version of cached pixmap
+  QPoint  cacheOffset_;              //!< scroll offset of cached pixmap
+  QSize   cacheSize_;                //!< size of cached pixmap
 };
 
 }
@@ -5,11 +5,15 @@
 
 #include <QString>
 #include <QVariant>
+#include <QHash>
 
 #include <tcl.h>
 
 #include <optional>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <set>
 #include <map>
@@ -22,13 +26,94 @@ namespace CQTclCmd {
 class CmdProc;
 class Cmd;
 class CmdArgs;
+class CmdSchema;
+
+using CmdSchemaP = std::shared_ptr<const CmdSchema>;
+
+/*!
+ * \brief per command call statistics (lock free counters, updated when profiling)
+ */
+class CmdStats {
+ public:
+  CmdStats() { }
+
+  //! add call (parse and total times in nanoseconds)
+  void add(int64_t parseNs, int64_t totalNs);
+
+  //! reset counters
+  void reset();
+
+  int64_t count  () const { return count_  .load(std::memory_order_relaxed); }
+  int64_t totalNs() const { return totalNs_.load(std::memory_order_relaxed); }
+  int64_t parseNs() const { return parseNs_.load(std::memory_order_relaxed); }
+  int64_t execNs () const { return totalNs() - parseNs(); }
+  int64_t minNs  () const { return (count() > 0 ? minNs_.load(std::memory_order_relaxed) : 0); }
+  int64_t maxNs  () const { return maxNs_  .load(std::memory_order_relaxed); }
+
+ private:
+  CmdStats(const CmdStats &) = delete;
+  CmdStats &operator=(const CmdStats &) = delete;
+
+ private:
+  std::atomic<int64_t> count_   { 0 };
+  std::atomic<int64_t> totalNs_ { 0 };
+  std::atomic<int64_t> parseNs_ { 0 };
+  std::atomic<int64_t> minNs_   { INT64_MAX };
+  std::atomic<int64_t> maxNs_   { 0 };
+};
+
+//---
+
+/*!
+ * \brief prefix tree of names (for completion)
+ */
+class NameTrie {
+ public:
+  NameTrie();
+
+  //! add/remove name
+  void add   (const QString &name);
+  bool remove(const QString &name);
+
+  //! has name
+  bool contains(const QString &name) const;
+
+  //! get number of names
+  int size() const { return nodes_[0].count; }
+
+  //! get names starting with prefix (sorted)
+  QStringList match(const QString &prefix) const;
+
+  //! get longest completion of prefix (empty if no match, exact if single name)
+  QString longestMatch(const QString &prefix, bool &exact) const;
+
+ private:
+  struct Node {
+    std::map<QChar, int> children;           //!< child node index per char
+    bool                 terminal { false }; //!< name ends at node
+    int                  count    { 0 };     //!< number of names in subtree
+  };
+
+  using Nodes = std::vector<Node>;
+
+  int findNode(const QString &prefix) const;
+
+  void addNames(int ind, QString &name, QStringList &names) const;
+
+ private:
+  Nodes nodes_;
+};
+
+//---
 
 /*!
  * \brief Tcl Command Manager
  */
 class Mgr {
  public:
-  using Vars = std::vector<QVariant>;
+  using Vars         = std::vector<QVariant>;
+  using CommandNames = std::vector<QString>;
+  using NameValueMap = std::map<QString, QString>;
 
  public:
   Mgr(CQTcl *qtcl);
@@ -43,25 +128,63 @@ class Mgr {
 
   bool processCmd(const QString &name, const Vars &vars);
 
+  bool processCmd(const QString &name, int objc, const Tcl_Obj **objv);
+
   CmdProc *getCommand(const QString &name) const;
 
   virtual Cmd *createCmd(const QString &name);
 
   virtual CmdArgs *createArgs(const QString &name, const Vars &vars);
 
+  virtual CmdArgs *createArgs(const QString &name, int objc, const Tcl_Obj **objv);
+
   //---
 
   bool help(const QString &pattern, bool verbose, bool hidden);
 
   void helpAll(bool verbose, bool hidden);
 
+  //---
+
+  //! get command names (in add order)
+  const CommandNames &commandNames() const { return commandNames_; }
+
+  //---
+
+  // in process completion (no Tcl evaluation)
+
+  //! get matching command names / longest command name completion
+  QStringList matchCommands(const QString &prefix) const;
+  QString completeCommand(const QString &prefix, bool &exact) const;
+
+  //! get matching option names / longest option name completion (no '-')
+  QStringList matchOptions(const QString &command, const QString &prefix) const;
+  QString completeOption(const QString &command, const QString &prefix, bool &exact) const;
+
+  //! get option values / longest option value completion
+  QStringList optionValues(const QString &command, const QString &option,
+                           const NameValueMap &nameValueMap=NameValueMap()) const;
+  QString completeValue(const QString &command, const QString &option, const QString &prefix,
+                        const NameValueMap &nameValueMap, bool &exact) const;
+
+  //! get/set profiling (record per command call statistics)
+  bool isProfiling() const { return profiling_.load(std::memory_order_relaxed); }
+  void setProfiling(bool b) { profiling_.store(b, std::memory_order_relaxed); }
+
+  //! reset all command statistics
+  void resetProfile();
+
+ protected:
+  bool execCmd(CmdProc *proc, CmdArgs *args);
+
  protected:
-  using CommandNames = std::vector<QString>;
   using CommandProcs = std::map<QString, CmdProc *>;
 
-  CQTcl*       qtcl_ { nullptr };
-  CommandNames commandNames_;
-  CommandProcs commandProcs_;
+  CQTcl*            qtcl_      { nullptr };
+  CommandNames      commandNames_;
+  CommandProcs      commandProcs_;
+  NameTrie          commandTrie_;
+  std::atomic<bool> profiling_ { false };
 };
 
 /*!
@@ -78,7 +201,8 @@ class CmdArg {
     String,
     SBool,
     Enum,
-    Extra
+    Extra,
+    Object
   };
 
   using NameValue  = std::pair<QString, int>;
@@ -158,6 +282,43 @@ class CmdGroup {
 
 //---
 
+/*!
+ * \brief immutable command argument schema (built once per command proc)
+ */
+class CmdSchema {
+ public:
+  using CmdArgArray = std::vector<CmdArg>;
+  using CmdGroups   = std::vector<CmdGroup>;
+
+ public:
+  CmdSchema(const CmdArgArray &cmdArgs, const CmdGroups &cmdGroups);
+
+  const CmdArgArray &cmdArgs() const { return cmdArgs_; }
+
+  const CmdGroups &cmdGroups() const { return cmdGroups_; }
+
+  //! get argument slot (index into cmdArgs) for option name (-1 if not found)
+  int optSlot(const QString &name) const { return optSlots_.value(name, -1); }
+
+  //! get option names trie
+  const NameTrie &optTrie() const { return optTrie_; }
+
+  //! get fixed values trie for option slot (enum and string bool) (nullptr if none)
+  const NameTrie *valueTrie(int slot) const;
+
+ private:
+  using OptSlots   = QHash<QString, int>;
+  using ValueTries = std::map<int, NameTrie>;
+
+  CmdArgArray cmdArgs_;    //!< command argument data
+  CmdGroups   cmdGroups_;  //!< command argument groups
+  OptSlots    optSlots_;   //!< option name to argument slot
+  NameTrie    optTrie_;    //!< option names
+  ValueTries  valueTries_; //!< fixed option values by slot
+};
+
+//---
+
 /*!
  * \brief base class for handling command arguments
  */
@@ -175,27 +336,38 @@ class CmdArgs {
    public:
     Arg(const QVariant &var=QVariant());
 
+    Arg(Tcl_Interp *interp, Tcl_Obj *obj);
+
   //QString  str() const { assert(! isOpt_); return toString(var_); }
-    QVariant var() const { assert(! isOpt_); return var_; }
+    QVariant var() const { assert(! isOpt_); return (obj_ ? objVar() : var_); }
 
     bool isOpt() const { return isOpt_; }
     void setIsOpt(bool b) { isOpt_ = b; }
 
-    QString opt() const { assert(isOpt_); return toString(var_).mid(1); }
+    QString opt() const;
+
+   private:
+    QVariant objVar() const;
 
    protected:
-    QVariant var_;             //!< arg value
-    bool     isOpt_ { false }; //!< is option
+    QVariant    var_;                //!< arg value
+    Tcl_Interp* interp_ { nullptr }; //!< interp (Tcl object arg)
+    Tcl_Obj*    obj_    { nullptr }; //!< Tcl object arg value
+    bool        isOpt_  { false };   //!< is option
   };
 
   using CmdArgArray = std::vector<CmdArg>;
+  using CmdGroups   = std::vector<CmdGroup>;
 
   //---
 
  public:
   CmdArgs(const QString &cmdName, const Args &argv);
 
-  virtual ~CmdArgs() { }
+  // args read directly from Tcl objects (no variant conversion)
+  CmdArgs(const QString &cmdName, Tcl_Interp *interp, int objc, const Tcl_Obj **objv);
+
+  virtual ~CmdArgs();
 
   //---
 
@@ -211,7 +383,17 @@ class CmdArgs {
   CmdArg &addCmdArg(const QString &name, int type,
                     const QString &argDesc="", const QString &desc="");
 
-  const CmdArgArray &cmdArgs() const { return cmdArgs_; }
+  // get argument data (from schema if set)
+  const CmdArgArray &cmdArgs() const { return (schema_ ? schema_->cmdArgs() : cmdArgs_); }
+
+  // get argument groups (from schema if set)
+  const CmdGroups &cmdGroups() const { return (schema_ ? schema_->cmdGroups() : cmdGroups_); }
+
+  //---
+
+  // get/set prebuilt argument schema (replaces added arguments)
+  const CmdSchemaP &schema() const { return schema_; }
+  void setSchema(const CmdSchemaP &schema) { schema_ = schema; }
 
   //---
 
@@ -263,6 +445,13 @@ class CmdArgs {
   bool isDebug() const { return debug_; }
   void setDebug(bool b) { debug_ = b; }
 
+  // get/set time parse (for profiling)
+  bool isTimed() const { return timed_; }
+  void setTimed(bool b) { timed_ = b; }
+
+  // get time spent in parse (nanoseconds, if timed)
+  int64_t parseNs() const { return parseNs_; }
+
   //---
 
   // parse command arguments
@@ -270,7 +459,7 @@ class CmdArgs {
 
   bool parse(bool &rc);
 
-  virtual bool handleParseArg(CmdArg *cmdArg, const QString &opt);
+  virtual bool handleParseArg(const CmdArg *cmdArg, const QString &opt);
 
   //---
 
@@ -306,26 +495,51 @@ class CmdArgs {
   // get parsed optional boolean for option
   OptBool getParseOptBool(const QString &name) const;
 
+  // get parsed Tcl object for option (nullptr if not found)
+  Tcl_Obj *getParseObj(const QString &name) const;
+
   //---
 
   // get parsed generic value for option
   template<typename T>
   T getParseValue(const QString &name, const T &def=T()) const {
-    auto p = parseStr_.find(name);
-    if (p == parseStr_.end()) return def;
+    auto *value = parseValue(argSlot(name), ParseValue::Type::Strings);
+    if (! value) return def;
 
-    return T((*p).second[0]);
+    return T(value->strs[0]);
   }
 
   //---
 
+  // get argument slot for option name (-1 if not found)
+  // (slot accessors avoid name lookup for repeated access)
+  int argSlot(const QString &name) const;
+
+  // check if option slot found by parse
+  bool hasParseSlot(int slot) const;
+
+  // get parsed values for option slot (default returned if not found)
+  int         getSlotInt (int slot, int def=0) const;
+  double      getSlotReal(int slot, double def=0.0) const;
+  QStringList getSlotStrs(int slot) const;
+  QString     getSlotStr (int slot, const QString &def="") const;
+  bool        getSlotBool(int slot, bool def=false) const;
+  Tcl_Obj*    getSlotObj (int slot) const;
+
+  //---
+
   // get parsed args (non options)
   const Args &getParseArgs() const { return parseArgs_; }
 
   //---
 
   // get arg data for option
-  CmdArg *getCmdOpt(const QString &name);
+  const CmdArg *getCmdOpt(const QString &name) const;
+
+  //---
+
+  // are args Tcl objects
+  bool isObjArgs() const { return interp_ != nullptr; }
 
   //---
 
@@ -362,12 +576,38 @@ class CmdArgs {
   static bool stringToBool(const QString &str, bool *ok);
 
  protected:
-  using CmdGroups   = std::vector<CmdGroup>;
-  using NameInt     = std::map<QString, int>;
-  using NameReal    = std::map<QString, double>;
-  using NameString  = std::map<QString, QString>;
-  using NameStrings = std::map<QString, QStringList>;
-  using NameBool    = std::map<QString, bool>;
+  using ObjArgs = std::vector<Tcl_Obj *>;
+
+  // parsed option value (one per argument slot)
+  struct ParseValue {
+    enum class Type {
+      None,
+      Integer,
+      Real,
+      Strings,
+      Boolean,
+      Object
+    };
+
+    Type        type { Type::None };
+    int         i    { 0 };
+    double      r    { 0.0 };
+    bool        b    { false };
+    QStringList strs;
+    Tcl_Obj*    obj  { nullptr };
+  };
+
+  using ParseValues = std::vector<ParseValue>;
+
+ protected:
+  // parse command arguments (untimed)
+  bool parseArgs(bool &rc);
+
+  // get parsed value for slot of type (nullptr if not found)
+  const ParseValue *parseValue(int slot, ParseValue::Type type) const;
+
+  // set parsed value for option
+  ParseValue &setParseValue(const CmdArg *cmdArg, ParseValue::Type type);
 
  protected:
   // get option names for group
@@ -377,23 +617,32 @@ class CmdArgs {
   void getGroupCmdArgs(int groupInd, CmdArgArray &cmdArgs) const;
 
  protected:
+  // get next option value Tcl object (nullptr if none)
+  Tcl_Obj *nextObj();
+
+  // get option value as Tcl object (created from variant for variant args)
+  Tcl_Obj *getOptObj();
+
   // display error message
   void errorMsg(const QString &msg);
 
  protected:
   QString     cmdName_;             //! command name being processed
   bool        debug_     { false }; //! is debug
+  bool        timed_     { false }; //! time parse
+  int64_t     parseNs_   { 0 };     //! parse time (nanoseconds)
   Args        argv_;                //! input args
+  Tcl_Interp* interp_    { nullptr }; //! interp for object args
+  ObjArgs     objv_;                //! input object args
+  ObjArgs     ownedObjs_;           //! objects created for variant args
   int         i_         { 0 };     //! current arg
   int         argc_      { 0 };     //! number of args
   Arg         lastArg_;             //! last processed arg
   CmdArgArray cmdArgs_;             //! command argument data
   CmdGroups   cmdGroups_;           //! command argument groups
+  CmdSchemaP  schema_;              //! prebuilt argument schema
   int         groupInd_  { -1 };    //! current group index
-  NameInt     parseInt_;            //! parsed option integers
-  NameReal    parseReal_;           //! parsed option reals
-  NameStrings parseStr_;            //! parsed option strings
-  NameBool    parseBool_;           //! parsed option booleans
+  ParseValues parseValues_;         //! parsed option values (by slot)
   Args        parseArgs_;           //! parsed arguments
 };
 
@@ -451,15 +700,24 @@ class CmdProc {
 
   virtual void addArgs(CmdArgs & /*args*/) { }
 
+  // get argument schema (built from addArgs on first use)
+  const CmdSchemaP &schema();
+
+  // get call statistics
+  CmdStats &stats() { return stats_; }
+  const CmdStats &stats() const { return stats_; }
+
   virtual QStringList getArgValues(const QString& /*arg*/,
                                    const NameValueMap& /*nameValueMap*/ = NameValueMap()) {
     return QStringList();
   }
 
  protected:
-  Mgr*    mgr_ { nullptr };
-  QString name_;
-  Cmd*    cmd_ { nullptr };
+  Mgr*       mgr_ { nullptr };
+  QString    name_;
+  Cmd*       cmd_ { nullptr };
+  CmdSchemaP schema_;
+  CmdStats   stats_;
 };
 
 //---
@@ -9,57 +9,75 @@
 #include <QPointF>
 #include <QRectF>
 #include <QPolygonF>
+#include <QHash>
+#include <algorithm>
+#include <list>
 #include <set>
 
 namespace CQTclUtil {
 
 using Vars = std::vector<QVariant>;
 
+// string bridge (Qt <-> Tcl UTF-8), single encode into/decode from Tcl_Obj buffer
+
+inline Tcl_Obj *newStringObj(const QString &str) {
+  auto ba = str.toUtf8();
+
+  return Tcl_NewStringObj(ba.constData(), ba.size());
+}
+
+inline QString stringFromObj(Tcl_Obj *obj) {
+  int len = 0;
+
+  const char *str = Tcl_GetStringFromObj(obj, &len);
+
+  return QString::fromUtf8(str, len);
+}
+
+//---
+
 inline int eval(Tcl_Interp *interp, const QString &str) {
-  return Tcl_EvalEx(interp, str.toLatin1().constData(), -1, 0);
+  auto ba = str.toUtf8();
+
+  return Tcl_EvalEx(interp, ba.constData(), ba.size(), 0);
 }
 
 //---
 
 inline bool splitList(const QString &str, QStringList &strs) {
-  int    argc;
-  char **argv;
+  auto *obj = newStringObj(str);
 
-  std::string cstr = str.toStdString();
+  Tcl_IncrRefCount(obj);
 
-  int rc = Tcl_SplitList(0, cstr.c_str(), &argc, const_cast<const char ***>(&argv));
+  int       n    = 0;
+  Tcl_Obj **objs = nullptr;
 
-  if (rc != TCL_OK)
-    return false;
+  int rc = Tcl_ListObjGetElements(nullptr, obj, &n, &objs);
 
-  for (int i = 0; i < argc; ++i)
-    strs << QString(argv[i]);
+  if (rc == TCL_OK) {
+    for (int i = 0; i < n; ++i)
+      strs << stringFromObj(objs[i]);
+  }
 
-  Tcl_Free(reinterpret_cast<char *>(argv));
+  Tcl_DecrRefCount(obj);
 
-  return true;
+  return (rc == TCL_OK);
 }
 
 inline QString mergeList(const QStringList &strs) {
-  auto argc = size_t(strs.size());
-
-  std::vector<char *> argv;
-
-  argv.resize(argc);
-
-  for (size_t i = 0; i < argc; ++i)
-    argv[i] = strdup(strs[int(i)].toLatin1().constData());
+  // build list object (Tcl quotes elements when string rep generated)
+  auto *obj = Tcl_NewListObj(0, nullptr);
 
-  char *res = Tcl_Merge(int(argc), &argv[0]);
+  Tcl_IncrRefCount(obj);
 
-  QString str(res);
+  for (const auto &str : strs)
+    Tcl_ListObjAppendElement(nullptr, obj, newStringObj(str));
 
-  for (size_t i = 0; i < argc; ++i)
-    free(argv[i]);
+  auto res = stringFromObj(obj);
 
-  Tcl_Free(res);
+  Tcl_DecrRefCount(obj);
 
-  return str;
+  return res;
 }
 
 inline bool stringToModelIndex(const QString &str, int &row, int &col) {
@@ -110,9 +128,7 @@ inline bool isSupportedVariant(const QVariant &var) {
 
 inline Tcl_Obj *variantToObj(Tcl_Interp *interp, const QVariant &var) {
   if      (var.type() == QVariant::String) {
-    auto str = var.toString();
-
-    return Tcl_NewStringObj(str.toLatin1().constData(), -1);
+    return newStringObj(var.toString());
   }
   else if (var.type() == QVariant::Double) {
     return Tcl_NewDoubleObj(var.value<double>());
@@ -210,7 +226,7 @@ inline Tcl_Obj *variantToObj(Tcl_Interp *interp, const QVariant &var) {
     int ns = strs.length();
 
     for (int i = 0; i < ns; ++i) {
-      auto *sobj = variantToObj(interp, strs[i]);
+      auto *sobj = newStringObj(strs[i]);
 
       Tcl_ListObjAppendElement(interp, obj, sobj);
     }
@@ -241,7 +257,7 @@ inline Tcl_Obj *variantToObj(Tcl_Interp *interp, const QVariant &var) {
     if (var.canConvert(QVariant::String))
       str = var.toString();
 
-    return Tcl_NewStringObj(str.toLatin1().constData(), -1);
+    return newStringObj(str);
   }
 }
 
@@ -306,15 +322,8 @@ inline QVariant variantFromObj(Tcl_Interp *interp, const Tcl_Obj *obj) {
     }
   }
 
-  if (! var.isValid()) {
-    int len = 0;
-
-    char *str = Tcl_GetStringFromObj(obj1, &len);
-
-    std::string cstr(str, size_t(len));
-
-    var = QVariant(QString(cstr.c_str()));
-  }
+  if (! var.isValid())
+    var = QVariant(stringFromObj(obj1));
 
   Tcl_DecrRefCount(obj1);
 
@@ -336,11 +345,7 @@ inline QString variantListToString(const QVariantList &vars) {
 
   Tcl_IncrRefCount(obj);
 
-  int len = 0;
-
-  char *str = Tcl_GetStringFromObj(obj, &len);
-
-  QString qstr(str);
+  auto qstr = stringFromObj(obj);
 
   Tcl_DecrRefCount(obj);
 
@@ -351,7 +356,7 @@ inline QString variantListToString(const QVariantList &vars) {
 
 inline void createVar(Tcl_Interp *interp, const QString &name, const QVariant &var) {
   if (var.isValid()) {
-    auto *nameObj  = variantToObj(interp, name); Tcl_IncrRefCount(nameObj);
+    auto *nameObj  = newStringObj(name); Tcl_IncrRefCount(nameObj);
     auto *valueObj = variantToObj(interp, var );
 
     Tcl_ObjSetVar2(interp, nameObj, nullptr, valueObj, TCL_GLOBAL_ONLY);
@@ -363,7 +368,7 @@ inline void createVar(Tcl_Interp *interp, const QString &name, const QVariant &v
 //---
 
 inline QVariant getVar(Tcl_Interp *interp, const QString &name) {
-  auto *nameObj = variantToObj(interp, name); Tcl_IncrRefCount(nameObj);
+  auto *nameObj = newStringObj(name); Tcl_IncrRefCount(nameObj);
 
   auto *obj = Tcl_ObjGetVar2(interp, nameObj, nullptr, TCL_GLOBAL_ONLY);
 
@@ -378,7 +383,7 @@ inline QVariant getVar(Tcl_Interp *interp, const QString &name) {
 //---
 
 inline Vars getListVar(Tcl_Interp *interp, const QString &name) {
-  auto *nameObj = variantToObj(interp, name); Tcl_IncrRefCount(nameObj);
+  auto *nameObj = newStringObj(name); Tcl_IncrRefCount(nameObj);
 
   auto *obj = Tcl_ObjGetVar2(interp, nameObj, nullptr, TCL_GLOBAL_ONLY);
 
@@ -413,10 +418,30 @@ inline void setResult(Tcl_Interp *interp, const QVariant &var) {
 
 //---
 
+inline void setResult(Tcl_Interp *interp, int i) {
+  Tcl_SetObjResult(interp, Tcl_NewIntObj(i));
+}
+
+inline void setResult(Tcl_Interp *interp, double r) {
+  Tcl_SetObjResult(interp, Tcl_NewDoubleObj(r));
+}
+
+inline void setResult(Tcl_Interp *interp, const QString &str) {
+  Tcl_SetObjResult(interp, newStringObj(str));
+}
+
 inline void setResult(Tcl_Interp *interp, const QStringList &strs) {
-  auto *obj = variantToObj(interp, strs);
+  // build list elements directly (no variant per element)
+  int ns = strs.length();
 
-  Tcl_SetObjResult(interp, obj);
+  std::vector<Tcl_Obj *> objs;
+
+  objs.resize(size_t(ns));
+
+  for (int i = 0; i < ns; ++i)
+    objs[size_t(i)] = newStringObj(strs[i]);
+
+  Tcl_SetObjResult(interp, Tcl_NewListObj(ns, objs.data()));
 }
 
 //---
@@ -515,9 +540,11 @@ class CQTcl : public QObject, public CTcl {
     int flags = TCL_TRACE_READS | TCL_TRACE_WRITES | TCL_TRACE_UNSETS | TCL_GLOBAL_ONLY;
 
     for (const auto &name : traces_) {
-      Tcl_UntraceVar(interp(), name.toLatin1().constData(), flags,
+      Tcl_UntraceVar(interp(), name.toUtf8().constData(), flags,
         &CQTcl::traceProc, static_cast<ClientData>(this));
     }
+
+    clearScripts();
   }
 
   void createVar(const QString &name, const QVariant &var) {
@@ -547,8 +574,8 @@ class CQTcl : public QObject, public CTcl {
   const QStringList &commandNames() const { return commandNames_; }
 
   int createAlias(const QString &newName, const QString &oldName) {
-    return Tcl_CreateAlias(interp(), newName.toLatin1().constData(),
-                           interp(), oldName.toLatin1().constData(),
+    return Tcl_CreateAlias(interp(), newName.toUtf8().constData(),
+                           interp(), oldName.toUtf8().constData(),
                            0, nullptr);
   }
 
@@ -604,7 +631,8 @@ class CQTcl : public QObject, public CTcl {
   }
 
   int eval(const QString &cmd, EvalData &evalData) {
-    int rc = CQTclUtil::eval(interp(), cmd);
+    // evaluate cached script object (reuses compiled bytecode)
+    int rc = Tcl_EvalObjEx(interp(), scriptObj(cmd), 0);
 
     if (rc != TCL_OK) {
       evalData.errMsg = errorInfo(rc);
@@ -687,10 +715,10 @@ class CQTcl : public QObject, public CTcl {
     int flags = TCL_TRACE_READS | TCL_TRACE_WRITES | TCL_TRACE_UNSETS | TCL_GLOBAL_ONLY;
 
     ClientData data =
-      Tcl_VarTraceInfo(interp(), name.toLatin1().constData(), flags, &CQTcl::traceProc, 0);
+      Tcl_VarTraceInfo(interp(), name.toUtf8().constData(), flags, &CQTcl::traceProc, 0);
 
     if (! data) {
-      Tcl_TraceVar(interp(), name.toLatin1().constData(), flags,
+      Tcl_TraceVar(interp(), name.toUtf8().constData(), flags,
         &CQTcl::traceProc, static_cast<ClientData>(this));
 
       traces_.insert(name);
@@ -700,21 +728,27 @@ class CQTcl : public QObject, public CTcl {
   void untraceVar(const QString &name) {
     int flags = TCL_TRACE_READS | TCL_TRACE_WRITES | TCL_TRACE_UNSETS | TCL_GLOBAL_ONLY;
 
-    Tcl_UntraceVar(interp(), name.toLatin1().constData(), flags,
+    Tcl_UntraceVar(interp(), name.toUtf8().constData(), flags,
       &CQTcl::traceProc, static_cast<ClientData>(this));
 
     traces_.erase(name);
   }
 
   virtual void handleTrace(const char *name, int flags) {
-    // ignore unset called on trace destruction
-    if (flags & TCL_TRACE_UNSETS) return;
+    // unset destroys trace so add it again (reports later set) unless interp deleted
+    if (flags & TCL_TRACE_UNSETS) {
+      if ((flags & TCL_TRACE_DESTROYED) && ! (flags & TCL_INTERP_DESTROYED)) {
+        QString name1 = QString::fromUtf8(name);
 
-    std::cerr << "CQTcl::handleTrace (";
-    if (flags & TCL_TRACE_READS ) std::cerr << " read" ;
-    if (flags & TCL_TRACE_WRITES) std::cerr << " write";
-  //if (flags & TCL_TRACE_UNSETS) std::cerr << " unset";
-    std::cerr << ") " << name << "\n";
+        if (traces_.find(name1) != traces_.end())
+          traceVar(name1);
+      }
+
+      return;
+    }
+
+    if (flags & TCL_TRACE_READS ) emit varRead   (QString::fromUtf8(name));
+    if (flags & TCL_TRACE_WRITES) emit varWritten(QString::fromUtf8(name));
   }
 
   bool isSupportedVariant(const QVariant &var) {
@@ -725,6 +759,18 @@ class CQTcl : public QObject, public CTcl {
     CQTclUtil::setResult(interp(), rc);
   }
 
+  void setResult(int rc) {
+    CQTclUtil::setResult(interp(), rc);
+  }
+
+  void setResult(double rc) {
+    CQTclUtil::setResult(interp(), rc);
+  }
+
+  void setResult(const QString &rc) {
+    CQTclUtil::setResult(interp(), rc);
+  }
+
   void setResult(const QStringList &rc) {
     CQTclUtil::setResult(interp(), rc);
   }
@@ -745,12 +791,68 @@ class CQTcl : public QObject, public CTcl {
     return CTclUtil::errorInfo(interp(), rc).c_str();
   }
 
+  //---
+
+  //! get/set max number of cached script objects
+  int maxScripts() const { return maxScripts_; }
+  void setMaxScripts(int n) { maxScripts_ = n; pruneScripts(); }
+
+  //! get cached script object for script text (most recently used)
+  Tcl_Obj *scriptObj(const QString &script) {
+    auto p = scriptObjs_.find(script);
+
+    if (p != scriptObjs_.end()) {
+      scriptList_.splice(scriptList_.begin(), scriptList_, p.value());
+
+      return p.value()->obj;
+    }
+
+    auto *obj = CQTclUtil::newStringObj(script);
+
+    Tcl_IncrRefCount(obj);
+
+    scriptList_.push_front(ScriptData(script, obj));
+
+    scriptObjs_[script] = scriptList_.begin();
+
+    pruneScripts();
+
+    return obj;
+  }
+
+  //! release all cached script objects
+  void clearScripts() {
+    for (auto &scriptData : scriptList_)
+      Tcl_DecrRefCount(scriptData.obj);
+
+    scriptList_.clear();
+    scriptObjs_.clear();
+  }
+
  private:
+  void pruneScripts() {
+    // release least recently used (eval in progress keeps its own reference)
+    while (int(scriptList_.size()) > std::max(maxScripts_, 1)) {
+      auto &scriptData = scriptList_.back();
+
+      scriptObjs_.remove(scriptData.script);
+
+      Tcl_DecrRefCount(scriptData.obj);
+
+      scriptList_.pop_back();
+    }
+  }
+
   Tcl_Command createObjCommandI(const QString &name, ObjCmdProc proc, ObjCmdData data) {
-    return Tcl_CreateObjCommand(interp(), const_cast<char *>(name.toLatin1().constData()),
+    return Tcl_CreateObjCommand(interp(), const_cast<char *>(name.toUtf8().constData()),
                                 proc, data, nullptr);
   }
 
+ Q_SIGNALS:
+  //! emitted when traced variable is read/written
+  void varRead   (const QString &name);
+  void varWritten(const QString &name);
+
  private:
   static char *traceProc(ClientData data, Tcl_Interp *, const char *name1,
                          const char *, int flags) {
@@ -763,8 +865,23 @@ class CQTcl : public QObject, public CTcl {
   }
 
  private:
+  struct ScriptData {
+    QString  script;
+    Tcl_Obj* obj { nullptr };
+
+    ScriptData(const QString &script, Tcl_Obj *obj) :
+     script(script), obj(obj) {
+    }
+  };
+
+  using ScriptList = std::list<ScriptData>;
+  using ScriptObjs = QHash<QString, ScriptList::iterator>;
+
   Traces      traces_;
   QStringList commandNames_;
+  ScriptList  scriptList_;        //!< cached script objects (front most recently used)
+  ScriptObjs  scriptObjs_;        //!< script text to cached script object
+  int         maxScripts_ { 256 };
 };
 
 #endif
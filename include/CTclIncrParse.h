@@ -0,0 +1,74 @@
+#ifndef CTclIncrParse_H
+#define CTclIncrParse_H
+
+#include <CTclParse.h>
+#include <string>
+#include <vector>
+
+// incremental parse of an edit buffer
+//
+// text is split into top level commands (newline or ';' outside braces, brackets,
+// quotes and array variable indices). After an edit, text is only rescanned from the start of the command
+// containing the edit until the scan reaches an unchanged old command boundary, and
+// tokens are only created for the command being queried.
+class CTclIncrParse {
+ public:
+  using Tokens = CTclParse::Tokens;
+
+ public:
+  CTclIncrParse();
+
+  //! get text
+  const std::string &text() const { return text_; }
+
+  //! set text (edit is common prefix/suffix difference with current text)
+  void setText(const std::string &text);
+
+  //! replace len chars at pos with str
+  void replace(int pos, int len, const std::string &str);
+
+  void insert(int pos, const std::string &str) { replace(pos, 0, str); }
+  void remove(int pos, int len) { replace(pos, len, ""); }
+
+  //! is text complete (no unterminated braces, brackets, quotes or array indices)
+  bool isComplete() const { return complete_; }
+
+  //! get number of top level commands
+  int numCommands() const { return int(starts_.size()); }
+
+  //! get range (start to end, exclusive) of command containing pos
+  void commandRange(int pos, int &start, int &end) const;
+
+  //! get tokens of command containing pos (token positions are relative to start)
+  const Tokens &commandTokens(int pos, int &start, int &end);
+
+  //! get position index of last queried command tokens (positions relative to start)
+  const CTclTokenIndex &tokenIndex() const { return parse_.tokenIndex(); }
+
+  //! get token for position relative to start of last queried command
+  CTclToken *getTokenForPos(int pos) const { return tokenIndex().tokenForPos(pos); }
+
+  //! get number of chars scanned by last edit
+  int numScanned() const { return numScanned_; }
+
+ private:
+  int commandInd(int pos) const;
+
+  bool arrayIndex(int pos, int &end) const;
+
+  void scan(int ind, int editEnd, int delta, const std::vector<int> &oldStarts);
+
+ private:
+  using Starts = std::vector<int>;
+
+  std::string text_;
+  Starts      starts_      { 0 };     //!< command start positions
+  bool        complete_    { true };
+  CTclParse   parse_;
+  Tokens      tokens_;                //!< tokens of queried command
+  int         tokenStart_  { -1 };
+  int         tokenEnd_    { -1 };
+  int         numScanned_  { 0 };
+};
+
+#endif
@@ -5,11 +5,16 @@
 #include <list>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <algorithm>
+#include <utility>
+#include <CTclScanner.h>
 #include <sys/types.h>
 
-class CStrParse;
+class CTclTokenArena;
 
+// parse token (text is span of parse source, tokens are owned by parse arena)
 class CTclToken {
  public:
   enum class Type {
@@ -26,18 +31,45 @@ class CTclToken {
  public:
   using Tokens = std::vector<CTclToken *>;
 
+  // child tokens (array in arena)
+  class TokenArray {
+   public:
+    TokenArray(CTclToken **tokens=nullptr, int n=0) :
+     tokens_(tokens), n_(n) {
+    }
+
+    CTclToken **begin() const { return tokens_; }
+    CTclToken **end  () const { return tokens_ + n_; }
+
+    int  size () const { return n_; }
+    bool empty() const { return n_ == 0; }
+
+    CTclToken *operator[](int i) const { return tokens_[i]; }
+
+   private:
+    CTclToken** tokens_ { nullptr };
+    int         n_      { 0 };
+  };
+
  public:
-  CTclToken(Type type, const std::string &str, int lineNum, int linePos) :
-   type_(type), str_(str), lineNum_(lineNum), linePos_(linePos) {
+  CTclToken(Type type, const std::string_view *src, int pos, int len, int lineNum, int linePos) :
+   type_(type), src_(src), pos_(pos), len_(len), lineNum_(lineNum), linePos_(linePos) {
   }
 
   Type type() const { return type_; }
   void setType(Type type) { type_ = type; }
 
-  const std::string &str() const { return str_; }
+  //! get source text (empty until parse complete)
+  std::string_view str() const { return span(pos_, len_); }
+
+  //! get unquoted/unescaped text (source span unless escapes changed text)
+  std::string_view altStr() const {
+    if (altStr_) return std::string_view(altStr_, altLen_);
+    return span(altPos_, altLen_);
+  }
 
-  const std::string &altStr() const { return altStr_; }
-  void setAltStr(const std::string &s) { altStr_ = s; }
+  void setAltSpan(int pos, int len) { altStr_ = nullptr; altPos_ = pos; altLen_ = len; }
+  void setAltStr(const char *str, int len) { altStr_ = str; altPos_ = -1; altLen_ = len; }
 
   int lineNum() const { return lineNum_; }
   void setLineNum(int num) { lineNum_ = num; }
@@ -46,22 +78,19 @@ class CTclToken {
   void setLinePos(int pos) { linePos_ = pos; }
 
   int pos() const { return pos_; }
-  void setPos(int pos) { pos_ = pos; }
+  int len() const { return len_; }
 
-  int endPos() const { return pos_ + str_.size() - 1; }
+  int endPos() const { return pos_ + len_ - 1; }
 
-  void addToken(CTclToken *token) {
-    tokens_.push_back(token);
-  }
-
-  const Tokens &tokens() const { return tokens_; }
+  const TokenArray &tokens() const { return tokens_; }
+  void setTokens(const TokenArray &tokens) { tokens_ = tokens; }
 
-  bool hasPos(int pos) {
+  bool hasPos(int pos) const {
     return (pos >= pos_ && pos <= endPos());
   }
 
-  void print(std::ostream &os, bool children=true) {
-    os << typeName(type_) << ":" << str_ << "@" << pos_;
+  void print(std::ostream &os, bool children=true) const {
+    os << typeName(type_) << ":" << str() << "@" << pos_;
 
     if (children && ! tokens_.empty()) {
       os << '[';
@@ -73,8 +102,8 @@ class CTclToken {
     }
   }
 
-  void printStr(std::ostream &os, bool children=true) {
-    os << str_;
+  void printStr(std::ostream &os, bool children=true) const {
+    os << str();
 
     if (children && ! tokens_.empty()) {
       os << '[';
@@ -98,13 +127,149 @@ class CTclToken {
   }
 
  private:
-  Type        type_    { Type::NONE };
-  std::string str_;
-  std::string altStr_;
-  int         pos_     { -1 };
-  int         lineNum_ { -1 };
-  int         linePos_ { -1 };
-  Tokens      tokens_;
+  std::string_view span(int pos, int len) const {
+    if (! src_ || pos < 0 || len <= 0 || size_t(pos + len) > src_->size())
+      return std::string_view();
+
+    return src_->substr(size_t(pos), size_t(len));
+  }
+
+ private:
+  // no destructor is run for arena tokens so all members must be trivial
+  Type                    type_    { Type::NONE };
+  const std::string_view* src_     { nullptr };
+  int                     pos_     { -1 };
+  int                     len_     { 0 };
+  const char*             altStr_  { nullptr };
+  int                     altPos_  { -1 };
+  int                     altLen_  { 0 };
+  int                     lineNum_ { -1 };
+  int                     linePos_ { -1 };
+  TokenArray              tokens_;
+};
+
+//---
+
+// block allocator for parse tokens, child arrays and unescaped strings
+// (everything allocated for a parse is released together)
+class CTclTokenArena {
+ public:
+  using Tokens = std::vector<CTclToken *>;
+
+ public:
+  CTclTokenArena() { }
+ ~CTclTokenArena();
+
+  CTclTokenArena(const CTclTokenArena &) = delete;
+  CTclTokenArena &operator=(const CTclTokenArena &) = delete;
+
+  //! get/set source text referenced by tokens (arena takes ownership)
+  std::string_view source() const { return sourceView_; }
+
+  void setSource(CTclSource &&source) {
+    source_     = std::move(source);
+    sourceView_ = source_.view();
+  }
+
+  //! create tokens referencing source of other arena
+  void shareSource(const CTclTokenArena &arena) { srcView_ = &arena.sourceView_; }
+
+  //! take ownership of allocations of other arena
+  void adopt(CTclTokenArena &arena);
+
+  //! create token for source span
+  CTclToken *createToken(CTclToken::Type type, int pos, int len, int lineNum, int linePos);
+
+  //! create child token array
+  CTclToken::TokenArray createTokens(const Tokens &tokens);
+
+  //! create string copy
+  const char *createString(const std::string &str);
+
+  //! release all allocations
+  void clear();
+
+  //! get number of allocated blocks/tokens
+  int numBlocks() const { return int(blocks_.size()); }
+  int numTokens() const { return numTokens_; }
+
+ private:
+  void *alloc(size_t size, size_t align);
+
+ private:
+  struct Block {
+    char*  data { nullptr };
+    size_t size { 0 };
+    size_t used { 0 };
+  };
+
+  using Blocks = std::vector<Block>;
+
+  static constexpr size_t blockSize = 8192;
+
+  CTclSource              source_;
+  std::string_view        sourceView_;
+  const std::string_view* srcView_    { &sourceView_ }; //!< source of created tokens
+  Blocks                  blocks_;
+  int                     numTokens_  { 0 };
+};
+
+//---
+
+// sorted position index of token tree
+// (positions are split into segments each mapped to deepest token containing them)
+class CTclTokenIndex {
+ public:
+  using Tokens = std::vector<CTclToken *>;
+
+ public:
+  CTclTokenIndex() { }
+
+  //! build for tokens (sorted, children inside parents)
+  void build(const Tokens &tokens);
+
+  void clear() { segments_.clear(); }
+
+  //! get number of segments
+  int size() const { return int(segments_.size()); }
+
+  //! get segment token and range (end exclusive)
+  CTclToken *token(int i) const { return segments_[i].token; }
+
+  int start(int i) const { return segments_[i].start; }
+  int end  (int i) const { return segments_[i].end  ; }
+
+  //! get segment containing pos (-1 if none)
+  int findIndex(int pos) const;
+
+  //! get deepest token containing pos (nullptr if none)
+  CTclToken *tokenForPos(int pos) const {
+    int i = findIndex(pos);
+
+    return (i >= 0 ? token(i) : nullptr);
+  }
+
+  //! get last segment starting before pos (-1 if none)
+  int prevIndex(int pos) const;
+
+  //! get first segment ending after pos (size if none)
+  int nextIndex(int pos) const;
+
+ private:
+  void addToken(CTclToken *token, int end, int &pos);
+
+  void addSegment(int start, int end, CTclToken *token);
+
+ private:
+  struct Segment {
+    int        start { 0 };
+    int        end   { 0 };
+    CTclToken* token { nullptr };
+  };
+
+  using Segments = std::vector<Segment>;
+
+  Segments segments_;
 };
 
 //---
@@ -142,8 +307,14 @@ class CTclParse {
   char getSeparator() const { return separator_; }
   void setSeparator(char c) { separator_ = c; }
 
+  //! parse file/string into tokens
+  //! (tokens are owned by parser and valid until next parse or parser is destroyed)
   bool parseFile(const std::string &filename, Tokens &tokens);
 
+  //! get/set number of threads for file parse (0 for number of cores, 1 for serial)
+  int numThreads() const { return numThreads_; }
+  void setNumThreads(int n) { numThreads_ = std::max(n, 0); }
+
   bool isCompleteLine(const std::string &line);
 
   bool parseLine(const std::string &str, Tokens &tokens);
@@ -176,6 +347,12 @@ class CTclParse {
 
   CTclToken *getTokenForPos(const Tokens &tokens, int pos) const;
 
+  //! get position index of tokens from last parse
+  const CTclTokenIndex &tokenIndex() const { return index_; }
+
+  //! get token arena
+  const CTclTokenArena &arena() const { return arena_; }
+
   static bool needsBraces(const std::string &str);
 
   void syntaxError(const std::string &str, int initPos);
@@ -188,20 +365,41 @@ class CTclParse {
   };
 
  private:
-  bool isCompleteLine1(char endChar);
-
   ParseData getParseData() const;
 
-  CTclToken *createToken(CTclToken::Type type, const std::string &str,
-                         const ParseData &parseData) const;
+  struct Chunk {
+    int start   { 0 };
+    int end     { 0 };
+    int lineNum { 1 };
+  };
 
- private:
-  using ParseStack = std::vector<CStrParse *>;
+  using Chunks = std::vector<Chunk>;
+
+  bool parseFileParallel(const std::string &filename, int numThreads, Tokens &tokens);
+
+  static void splitChunks(std::string_view text, int minSize, Chunks &chunks);
 
-  CStrParse* parse_     { nullptr };
-  ParseStack parseStack_;
-  char       separator_ { ';' };
-  bool       debug_     { false };
+  bool parseChunk(const CTclTokenArena &arena, const Chunk &chunk, Tokens &tokens);
+
+  CTclToken *createToken(CTclToken::Type type, const ParseData &parseData,
+                         const Tokens &tokens=Tokens());
+
+  void setAltStr(CTclToken *token, const std::string &str, char endChar);
+
+  static CTclToken *getTokenForPos(CTclToken *const *begin, CTclToken *const *end, int pos);
+
+ private:
+  using ParseStack = std::vector<CTclScanner *>;
+
+  CTclScanner*   parse_     { nullptr };
+  ParseStack     parseStack_;
+  CTclTokenArena arena_;
+  CTclTokenIndex index_;
+  char           separator_  { ';' };
+  int            numThreads_ { 1 };
+  bool           debug_      { false };
+  bool           quiet_      { false }; //!< don't report syntax errors (chunk parse)
+  bool           strictEnd_  { false }; //!< unterminated string/command at end is error
 
 #ifdef DEBUG_LINES
   using FileLines = std::vector<std::string>;
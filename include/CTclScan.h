@@ -0,0 +1,36 @@
+#ifndef CTclScan_H
+#define CTclScan_H
+
+#include <vector>
+#include <cstddef>
+
+// structural scan of tcl text
+//
+// Positions of the chars which affect nesting and command boundaries are found in
+// bulk (16/32 bytes at a time using SSE2/AVX2 when available) so nesting is resolved
+// over the structural chars only.
+namespace CTclScan {
+
+//! structural char sets
+enum class Chars {
+  NESTING, //!< [ ] { } " ' and backslash
+  ALL      //!< nesting chars, newline, ';' and '$'
+};
+
+using Positions = std::vector<int>;
+
+//! get position of next structural char at or after pos (len if none)
+size_t findNext(const char *data, size_t pos, size_t len, Chars chars=Chars::ALL);
+
+//! add positions of all structural chars to positions
+void findAll(const char *data, size_t len, Positions &positions, Chars chars=Chars::ALL);
+
+//! is text complete (no unterminated brackets, braces or quotes, escaped chars skipped)
+bool isComplete(const char *data, size_t len);
+
+//! get name of instruction set used ("avx2", "sse2" or "scalar")
+const char *simdName();
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef CTclScanner_H
+#define CTclScanner_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cctype>
+
+// parse source text (string copy or memory mapped file)
+class CTclSource {
+ public:
+  CTclSource() { }
+ ~CTclSource();
+
+  CTclSource(CTclSource &&source);
+  CTclSource &operator=(CTclSource &&source);
+
+  CTclSource(const CTclSource &) = delete;
+  CTclSource &operator=(const CTclSource &) = delete;
+
+  //! set to copy of string
+  void setString(const std::string &str);
+
+  //! map file (file is read into string if it can't be mapped)
+  bool mapFile(const std::string &filename);
+
+  //! release text
+  void clear();
+
+  const char *data() const { return data_; }
+  size_t      size() const { return size_; }
+
+  std::string_view view() const { return std::string_view(data_, size_); }
+
+ private:
+  std::string str_;
+  void*       map_  { nullptr };
+  const char* data_ { "" };
+  size_t      size_ { 0 };
+};
+
+//---
+
+// character scanner for CTclParse
+//
+// When lines are joined a backslash-newline continuation and the blanks following it
+// scan as a single space, so file text is parsed in place and token positions are
+// offsets into the original text.
+class CTclScanner {
+ public:
+  CTclScanner();
+
+  //! scan copy of string
+  void setString(const std::string &str);
+
+  //! scan memory mapped file
+  bool mapFile(const std::string &filename);
+
+  //! scan range of text owned by caller (start is at line start)
+  void setRange(const char *data, int start, int end, int lineNum);
+
+  //! get/set join continuation lines
+  bool isJoinLines() const { return joinLines_; }
+  void setJoinLines(bool b) { joinLines_ = b; }
+
+  //! get scanned text (positions are offsets into this)
+  std::string_view text() const { return std::string_view(data_, size_t(len_)); }
+
+  //! take ownership of scanned text (scanner is empty afterwards)
+  CTclSource takeSource();
+
+  //---
+
+  bool eof() const { return pos_ >= len_; }
+
+  int getPos() const { return pos_; }
+
+  //! get line number (from 1) and line position (from 0) of current char
+  int lineNum() const { return lineNum_; }
+  int linePos() const { return linePos_; }
+
+  //! get current char (continuation is space)
+  char getCharAt() const {
+    if (pos_ >= len_) return '\0';
+
+    if (joinLines_ && isContinuation(pos_)) return ' ';
+
+    return data_[pos_];
+  }
+
+  bool isChar(char c) const { return (! eof() && getCharAt() == c); }
+
+  bool isSpace() const { return (! eof() && isspace(getCharAt())); }
+
+  void skipChar();
+
+  void skipSpace();
+
+  bool readChar(char *c);
+
+  //! unread last char read (single char)
+  void unreadChar();
+
+  //! read run of chars up to next structural char (see CTclScan)
+  std::string_view readPlain();
+
+  //! get text from pos to current position
+  std::string getBefore(int pos) const;
+
+  //! get text after current position
+  std::string getAfter() const;
+
+ private:
+  bool isContinuation(int pos) const {
+    return (data_[pos] == '\\' && pos + 1 < len_ && data_[pos + 1] == '\n');
+  }
+
+  void init();
+
+ private:
+  struct State {
+    int pos     { 0 };
+    int lineNum { 1 };
+    int linePos { 0 };
+  };
+
+  CTclSource  source_;
+  const char* data_      { "" };
+  int         len_       { 0 };
+  int         pos_       { 0 };
+  int         lineNum_   { 1 };
+  int         linePos_   { 0 };
+  State       prev_;
+  bool        joinLines_ { false };
+};
+
+#endif
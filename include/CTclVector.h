@@ -0,0 +1,109 @@
+#ifndef CTclVector_H
+#define CTclVector_H
+
+#include <tcl.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// typed numeric vector held as Tcl object internal rep
+// (values stored contiguously so commands can pass bulk data without per element boxing)
+namespace CTclVector {
+
+enum class Type {
+  Real,
+  Int64,
+  Float
+};
+
+using Shape = std::vector<int>;
+
+class Vector {
+ public:
+  Vector(Type type=Type::Real, size_t n=0);
+
+  Type type() const { return type_; }
+
+  //! get/set shape (product of dimensions must match size)
+  const Shape &shape() const { return shape_; }
+  bool setShape(const Shape &shape);
+
+  //! get number of values
+  size_t size() const;
+
+  //! get/set value (converted to/from type)
+  double value(size_t i) const;
+  void setValue(size_t i, double r);
+
+  //! get typed value data (nullptr if different type)
+  const double  *reals () const { return (type_ == Type::Real  ? reals_ .data() : nullptr); }
+  const int64_t *ints  () const { return (type_ == Type::Int64 ? ints_  .data() : nullptr); }
+  const float   *floats() const { return (type_ == Type::Float ? floats_.data() : nullptr); }
+
+  //! get values (size step) from start to end (exclusive)
+  Vector *slice(size_t start, size_t end, size_t step=1) const;
+
+  //! get values converted to type
+  Vector *convert(Type type) const;
+
+  //---
+
+  //! add/remove object reference (vectors are immutable and shared by duplicated objects)
+  void incRef() { ++refCount_; }
+  void decRef() { if (--refCount_ <= 0) delete this; }
+
+ private:
+ ~Vector() { }
+
+  Vector(const Vector &) = delete;
+  Vector &operator=(const Vector &) = delete;
+
+ private:
+  using Reals  = std::vector<double>;
+  using Ints   = std::vector<int64_t>;
+  using Floats = std::vector<float>;
+
+  Type   type_     { Type::Real };
+  Shape  shape_;
+  Reals  reals_;
+  Ints   ints_;
+  Floats floats_;
+  int    refCount_ { 0 };
+};
+
+//---
+
+//! reduction operations
+enum class Reduce {
+  Sum,
+  Min,
+  Max,
+  Mean
+};
+
+double reduce(const Vector *vector, Reduce op);
+
+//---
+
+//! register object type (safe to call multiple times)
+void registerType();
+
+//! get object type
+const Tcl_ObjType *objType();
+
+//! is object a vector (no conversion)
+bool isVector(Tcl_Obj *obj);
+
+//! create object for vector (takes reference)
+Tcl_Obj *newObj(Vector *vector);
+
+//! get vector for object (numeric lists are converted) (nullptr on error)
+Vector *getVector(Tcl_Interp *interp, Tcl_Obj *obj);
+
+//! get type name/type from name
+const char *typeName(Type type);
+bool nameToType(const char *name, Type &type);
+
+}
+
+#endif
@@ -1,10 +1,15 @@
 #include <CQDataFrame.h>
+#include <CQDataFrameScheduler.h>
+#include <CQDataFrameMemoryMgr.h>
+#include <CQDataFrameRasterCache.h>
+#include <CQDataFrameReactiveMgr.h>
 #include <CQDataFrameCommand.h>
 #include <CQDataFrameHistory.h>
 #include <CQDataFrameText.h>
 
+#include <CTclVector.h>
+
 #include <CQTabSplit.h>
-#include <CQStrUtil.h>
 
 #include <CFileMatch.h>
 #include <CFile.h>
@@ -17,6 +22,12 @@
 #include <QFile>
 #include <QTextStream>
 #include <QWheelEvent>
+#include <QRegExp>
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+#include <cmath>
 
 namespace CQDataFrame {
 
@@ -97,6 +108,14 @@ Frame(QWidget *parent) :
 {
   setObjectName("dataFrame");
 
+  // layout/repaint scheduler (must exist before areas add widgets)
+  scheduler_ = new Scheduler(this);
+
+  // cell payload memory budget
+  memoryMgr_ = new MemoryMgr(this);
+
+  //---
+
   auto *layout = new QVBoxLayout(this);
   layout->setMargin(0); layout->setSpacing(0);
 
@@ -129,6 +148,9 @@ Frame(QWidget *parent) :
 
   qtcl_->createAlias("echo", "puts");
 
+  // reactive cell variable dependencies (uses interpreter traces)
+  reactiveMgr_ = new ReactiveMgr(this);
+
   mgr_ = new CQTclCmd::Mgr(qtcl_);
 
   mgr_->addCommand("help", new HelpTclCmd(this));
@@ -137,6 +159,12 @@ Frame(QWidget *parent) :
 
   mgr_->addCommand("get_data", new GetDataTclCmd(this));
   mgr_->addCommand("set_data", new SetDataTclCmd(this));
+
+  CTclVector::registerType();
+
+  mgr_->addCommand("vector", new VectorTclCmd(this));
+
+  mgr_->addCommand("profile", new ProfileTclCmd(this));
 }
 
 Frame::
@@ -204,6 +232,59 @@ getWidget(const QString &name) const
   return w;
 }
 
+void
+Frame::
+getWidgets(const QStringList &ids, Widgets &widgets) const
+{
+  // widgets returned in order of ids (each widget once). An exact id resolves to
+  // first matching widget (as getWidget) and a pattern to all matching widgets
+  QSet<Widget *> widgetSet;
+
+  auto addWidget = [&](Widget *widget) {
+    if (widgetSet.contains(widget))
+      return;
+
+    widgetSet.insert(widget);
+
+    widgets.push_back(widget);
+  };
+
+  auto isPattern = [](const QString &id) {
+    return (id.contains('*') || id.contains('?') || id.contains('['));
+  };
+
+  // map id to first widget with id (built once if any exact ids)
+  QHash<QString, Widget *> idWidgets;
+
+  if (std::any_of(ids.begin(), ids.end(), [&](const QString &id) { return ! isPattern(id); })) {
+    for (auto *area : {larea(), rarea()}) {
+      for (auto *widget : area->widgets()) {
+        if (! idWidgets.contains(widget->id()))
+          idWidgets.insert(widget->id(), widget);
+      }
+    }
+  }
+
+  for (const auto &id : ids) {
+    if (isPattern(id)) {
+      QRegExp pattern(id, Qt::CaseSensitive, QRegExp::Wildcard);
+
+      for (auto *area : {larea(), rarea()}) {
+        for (auto *widget : area->widgets()) {
+          if (pattern.exactMatch(widget->id()))
+            addWidget(widget);
+        }
+      }
+    }
+    else {
+      auto *widget = idWidgets.value(id);
+
+      if (widget)
+        addWidget(widget);
+    }
+  }
+}
+
 //---
 
 bool
@@ -251,6 +332,15 @@ setCmdRc(const QStringList &rc)
   return true;
 }
 
+bool
+Frame::
+setCmdRc(Tcl_Obj *obj)
+{
+  Tcl_SetObjResult(qtcl()->interp(), obj);
+
+  return true;
+}
+
 //---
 
 void
@@ -353,9 +443,8 @@ void
 Scroll::
 updateContents()
 {
-  area()->update();
-
-  area()->placeWidgets();
+  // scroll moves single contents container (widgets keep their positions)
+  area()->scrollContents();
 }
 
 //---
@@ -366,6 +455,16 @@ Area(Scroll *scroll) :
 {
   setObjectName("area");
 
+  // container for widgets, moved as a whole to match scroll. Filled background
+  // makes it opaque so Qt can blit the moved contents and only expose new strip
+  contents_ = new QFrame(this);
+
+  contents_->setObjectName("contents");
+  contents_->setAutoFillBackground(true);
+
+  // only repaint newly exposed area on resize
+  contents_->setAttribute(Qt::WA_StaticContents);
+
   // single command entry widget
   if (scroll_->isCommand())
     command_ = makeWidget<CommandWidget>(this);
@@ -397,8 +496,11 @@ void
 Area::
 save(QTextStream &os)
 {
-  for (const auto &widget : widgets_)
+  for (const auto &widget : widgets_) {
+    widget->loadPayload();
+
     widget->save(os);
+  }
 }
 
 //---
@@ -423,7 +525,7 @@ void
 Area::
 addWidget(Widget *widget)
 {
-  widget->setParent(this);
+  widget->setParent(contents_);
   widget->setArea  (this);
 
   widget->setVisible(true);
@@ -456,12 +558,14 @@ addWidget(Widget *widget)
 
   connect(widget, SIGNAL(contentsChanged()), this, SLOT(updateWidgets()));
 
+  frame()->memoryMgr()->addWidget(widget);
+
   if (scroll_->isCommand())
     widget->setContentsMargins(margin(), margin(), margin(), margin());
   else
     widget->setContentsMargins(margin(), margin() + 16, margin(), margin());
 
-  placeWidgets();
+  schedulePlaceWidgets();
 }
 
 void
@@ -470,6 +574,8 @@ removeWidget(Widget *widget)
 {
   disconnect(widget, SIGNAL(contentsChanged()), this, SLOT(updateWidgets()));
 
+  frame()->memoryMgr()->removeWidget(widget);
+
   Widgets widgets;
 
   for (const auto &widget1 : widgets_)
@@ -480,7 +586,7 @@ removeWidget(Widget *widget)
 
   widget->setParent(nullptr);
 
-  placeWidgets();
+  schedulePlaceWidgets();
 }
 
 Widget *
@@ -498,13 +604,17 @@ void
 Area::
 updateWidgets()
 {
-  scroll_->updateContents();
+  // widget contents changed so size may have changed (relayout, coalesced per frame)
+  schedulePlaceWidgets();
 }
 
 void
 Area::
 scrollToEnd()
 {
+  // scroll size depends on pending placement
+  frame()->scheduler()->flushLayout(this);
+
   scroll()->ensureVisible(0, scroll()->getYSize());
 }
 
@@ -524,7 +634,7 @@ moveToEnd(Widget *widget)
 
   std::swap(widgets_, widgets);
 
-  placeWidgets();
+  schedulePlaceWidgets();
 }
 
 int
@@ -545,7 +655,7 @@ void
 Area::
 resizeEvent(QResizeEvent *)
 {
-  placeWidgets();
+  schedulePlaceWidgets();
 }
 
 bool
@@ -559,12 +669,27 @@ event(QEvent *e)
   return QFrame::event(e);
 }
 
+void
+Area::
+scrollContents()
+{
+  contents_->move(xOffset(), yOffset());
+}
+
+void
+Area::
+schedulePlaceWidgets()
+{
+  frame()->scheduler()->requestLayout(this);
+}
+
 void
 Area::
 placeWidgets()
 {
-  int xo = this->xOffset();
-  int yo = this->yOffset();
+  frame()->scheduler()->startLayout(this);
+
+  //---
 
   int maxWidth = 0, maxHeight = 0;
 
@@ -586,11 +711,11 @@ placeWidgets()
       // update max width for scrollbars
       maxWidth = std::max(maxWidth, x + w1);
 
-      // update widget position and move to match scroll
+      // update widget position and move (in unscrolled contents)
       widget->setX(x);
       widget->setY(y);
 
-      widget->move(x + xo, y + yo);
+      widget->move(x, y);
 
       // update widget size and resize widget
       widget->setWidgetWidth (w1);
@@ -607,18 +732,14 @@ placeWidgets()
     maxWidth  += margin();
     maxHeight  = y + margin();
   }
-  // dock area widgets are placed as requested (moved to match scroll)
+  // dock area widgets are placed as requested
   else {
     maxHeight = 0;
 
     for (const auto &widget : widgets_) {
       widget->updateSize();
 
-      // move to match scroll
-      int x1 = widget->x() + xo;
-      int y1 = widget->y() + yo;
-
-      widget->move(x1, y1);
+      widget->move(widget->x(), widget->y());
 
       //---
 
@@ -639,6 +760,11 @@ placeWidgets()
   scroll()->setXSize(maxWidth );
   scroll()->setYSize(maxHeight);
 
+  // size contents to widgets (at least visible area) and move to match scroll
+  contents_->resize(std::max(maxWidth, width()), std::max(maxHeight, height()));
+
+  scrollContents();
+
   //---
 
   QFontMetrics fm(font());
@@ -710,8 +836,6 @@ bool
 HelpTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   if (! argv.parse())
     return false;
 
@@ -760,8 +884,6 @@ bool
 CompleteTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   if (! argv.parse())
     return false;
 
@@ -792,72 +914,27 @@ exec(CQTclCmd::CmdArgs &argv)
 
   //---
 
+  auto *mgr = frame_->tclCmdMgr();
+
   if (argv.hasParseArg("option")) {
     // get option to complete
     auto option = argv.getParseStr("option");
 
-    auto optionStr = "-" + option;
-
-    //---
-
-    // get proc
-    auto *proc = frame_->tclCmdMgr()->getCommand(command);
-    if (! proc) return false;
-
-    //---
-
-    // get arg info
-    Vars vars;
-
-    CQTclCmd::CmdArgs args(command, vars);
-
-    proc->addArgs(args);
+    if (! mgr->getCommand(command))
+      return false;
 
     //---
 
     if (argv.hasParseArg("value")) {
-      // get option arg type
-      auto *arg = args.getCmdOpt(option);
-      if (! arg) return false;
-
-      auto type = arg->type();
-
-      //---
-
       // get value to complete
       auto value = argv.getParseStr("value");
 
-      //---
-
-      // complete by type
-      QStringList strs;
-
-      if      (type == int(ArgType::Boolean)) {
-      }
-      else if (type == int(ArgType::Integer)) {
-      }
-      else if (type == int(ArgType::Real)) {
-      }
-      else if (type == int(ArgType::SBool)) {
-        strs << "0" << "1";
-      }
-      else if (type == int(ArgType::String)) {
-        strs = proc->getArgValues(option, nameValueMap);
-      }
-      else {
-        return frame_->setCmdRc(strs);
-      }
-
-      //---
-
       if (allFlag)
-        return frame_->setCmdRc(strs);
-
-      auto matchValues = CQStrUtil::matchStrs(value, strs);
+        return frame_->setCmdRc(mgr->optionValues(command, option, nameValueMap));
 
       bool exact;
 
-      auto newValue = CQStrUtil::longestMatch(matchValues, exact);
+      auto newValue = mgr->completeValue(command, option, value, nameValueMap, exact);
 
       if (newValue.length() >= value.length()) {
         if (exact && exactSpace)
@@ -865,28 +942,18 @@ exec(CQTclCmd::CmdArgs &argv)
 
         return frame_->setCmdRc(newValue);
       }
-
-      return frame_->setCmdRc(strs);
     }
     else {
-      const auto &names = args.getCmdArgNames();
-
-      if (allFlag) {
-        QStringList strs;
-
-        for (const auto &name : names)
-          strs.push_back(name.mid(1));
-
-        return frame_->setCmdRc(strs);
-      }
-
-      auto matchArgs = CQStrUtil::matchStrs(optionStr, names);
+      if (allFlag)
+        return frame_->setCmdRc(mgr->matchOptions(command, ""));
 
       bool exact;
 
-      auto newOption = CQStrUtil::longestMatch(matchArgs, exact);
+      auto newOption = mgr->completeOption(command, option, exact);
+
+      if (newOption.length() >= option.length()) {
+        newOption = "-" + newOption;
 
-      if (newOption.length() >= optionStr.length()) {
         if (exact && exactSpace)
           newOption += " ";
 
@@ -895,16 +962,12 @@ exec(CQTclCmd::CmdArgs &argv)
     }
   }
   else {
-    const auto &cmds = frame_->qtcl()->commandNames();
-
-    auto matchCmds = CQStrUtil::matchStrs(command, cmds);
-
     if (allFlag)
-      return frame_->setCmdRc(matchCmds);
+      return frame_->setCmdRc(mgr->matchCommands(command));
 
     bool exact;
 
-    auto newCommand = CQStrUtil::longestMatch(matchCmds, exact);
+    auto newCommand = mgr->completeCommand(command, exact);
 
     if (newCommand.length() >= command.length()) {
       if (exact && exactSpace)
@@ -923,8 +986,8 @@ void
 GetDataTclCmd::
 addArgs(CQTclCmd::CmdArgs &argv)
 {
-  addArg(argv, "-id"  , ArgType::String, "object id");
-  addArg(argv, "-name", ArgType::String, "name");
+  addArg(argv, "-id"  , ArgType::String, "object ids or patterns");
+  addArg(argv, "-name", ArgType::String, "names");
 }
 
 QStringList
@@ -938,8 +1001,6 @@ bool
 GetDataTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -947,29 +1008,72 @@ exec(CQTclCmd::CmdArgs &argv)
 
   //---
 
-  auto id = argv.getParseStr("id");
+  QStringList ids, names;
 
-  auto *larea = frame_->larea();
-  auto *rarea = frame_->rarea();
+  CQTclUtil::splitList(argv.getParseStr("id"  ), ids  );
+  CQTclUtil::splitList(argv.getParseStr("name"), names);
 
-  auto *widget = larea->getWidget(id);
+  Frame::Widgets widgets;
 
-  if (! widget)
-    widget = rarea->getWidget(id);
+  frame_->getWidgets(ids, widgets);
 
-  if (! widget)
+  if (widgets.empty() || names.empty())
     return false;
 
   //---
 
-  auto name = argv.getParseStr("name");
+  auto getNameValues = [&](Widget *widget, QVariantList &nameValues) {
+    widget->loadPayload();
 
-  QVariant value;
+    for (const auto &name : names) {
+      QVariant value;
 
-  if (! widget->getNameValue(name, value))
-    return false;
+      if (! widget->getNameValue(name, value))
+        return false;
+
+      nameValues << QVariant(name) << value;
+    }
+
+    return true;
+  };
+
+  // single id and name returns value
+  bool singleId = (ids.length() == 1 && widgets.size() == 1 && widgets[0]->id() == ids[0]);
+
+  if (singleId && names.length() == 1) {
+    QVariant value;
+
+    widgets[0]->loadPayload();
+
+    if (! widgets[0]->getNameValue(names[0], value))
+      return false;
 
-  return frame_->setCmdRc(value);
+    return frame_->setCmdRc(value);
+  }
+
+  // single id returns dictionary of name values
+  if (singleId) {
+    QVariantList nameValues;
+
+    if (! getNameValues(widgets[0], nameValues))
+      return false;
+
+    return frame_->setCmdRc(nameValues);
+  }
+
+  // multiple ids return dictionary of id to name values dictionary
+  QVariantList idValues;
+
+  for (auto *widget : widgets) {
+    QVariantList nameValues;
+
+    if (! getNameValues(widget, nameValues))
+      return false;
+
+    idValues << QVariant(widget->id()) << QVariant(nameValues);
+  }
+
+  return frame_->setCmdRc(idValues);
 }
 
 //---
@@ -978,9 +1082,10 @@ void
 SetDataTclCmd::
 addArgs(CQTclCmd::CmdArgs &argv)
 {
-  addArg(argv, "-id"   , ArgType::String, "object id");
-  addArg(argv, "-name" , ArgType::String, "name");
-  addArg(argv, "-value", ArgType::String, "value");
+  addArg(argv, "-id"         , ArgType::String, "object ids or patterns");
+  addArg(argv, "-name"       , ArgType::String, "name");
+  addArg(argv, "-value"      , ArgType::String, "value");
+  addArg(argv, "-name_values", ArgType::String, "{name value ...}");
 }
 
 QStringList
@@ -994,8 +1099,6 @@ bool
 SetDataTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -1003,27 +1106,409 @@ exec(CQTclCmd::CmdArgs &argv)
 
   //---
 
-  auto id = argv.getParseStr("id");
+  QStringList ids;
 
-  auto *larea = frame_->larea();
-  auto *rarea = frame_->rarea();
+  CQTclUtil::splitList(argv.getParseStr("id"), ids);
 
-  auto *widget = larea->getWidget(id);
+  Frame::Widgets widgets;
 
-  if (! widget)
-    widget = rarea->getWidget(id);
+  frame_->getWidgets(ids, widgets);
 
-  if (! widget)
+  if (widgets.empty())
     return false;
 
   //---
 
-  auto name  = argv.getParseStr("name");
-  auto value = argv.getParseStr("value");
+  // get name values (single name/value and/or name value dictionary)
+  QStringList nameValues;
+
+  if (argv.hasParseArg("name"))
+    nameValues << argv.getParseStr("name") << argv.getParseStr("value");
+
+  if (argv.hasParseArg("name_values")) {
+    QStringList strs;
+
+    CQTclUtil::splitList(argv.getParseStr("name_values"), strs);
+
+    if (strs.length() % 2 != 0) {
+      std::cerr << "Invalid name values (expect name value pairs)\n";
+      return false;
+    }
+
+    nameValues << strs;
+  }
+
+  //---
+
+  // apply to all widgets (size changes schedule one merged relayout per area)
+  bool rc1 = true;
+
+  for (auto *widget : widgets) {
+    widget->loadPayload();
+
+    for (int i = 0; i < nameValues.length(); i += 2) {
+      if (! widget->setNameValue(nameValues[i], nameValues[i + 1]))
+        rc1 = false;
+    }
+  }
+
+  return rc1;
+}
+
+//---
+
+void
+VectorTclCmd::
+addArgs(CQTclCmd::CmdArgs &argv)
+{
+  argv.startCmdGroup(CQTclCmd::CmdGroup::Type::OneReq);
+  addArg(argv, "-values", ArgType::Object, "values list or vector");
+  addArg(argv, "-range" , ArgType::Object, "{start end ?step?}");
+  addArg(argv, "-slice" , ArgType::Object, "vector");
+  addArg(argv, "-reduce", ArgType::Object, "vector");
+  addArg(argv, "-info"  , ArgType::Object, "vector");
+  argv.endCmdGroup();
+
+  addArg(argv, "-type" , ArgType::String , "real|int64|float");
+  addArg(argv, "-shape", ArgType::Object , "dimensions");
+  addArg(argv, "-start", ArgType::Integer, "slice start");
+  addArg(argv, "-end"  , ArgType::Integer, "slice end (exclusive)");
+  addArg(argv, "-step" , ArgType::Integer, "slice step");
+  addArg(argv, "-op"   , ArgType::String , "sum|min|max|mean");
+}
+
+QStringList
+VectorTclCmd::
+getArgValues(const QString &arg, const NameValueMap &)
+{
+  if      (arg == "type")
+    return QStringList() << "real" << "int64" << "float";
+  else if (arg == "op")
+    return QStringList() << "sum" << "min" << "max" << "mean";
+
+  return QStringList();
+}
+
+bool
+VectorTclCmd::
+exec(CQTclCmd::CmdArgs &argv)
+{
+  bool rc;
+
+  if (! argv.parse(rc))
+    return rc;
+
+  //---
+
+  auto *interp = frame_->qtcl()->interp();
+
+  auto getVector = [&](const QString &name) {
+    auto *vector = CTclVector::getVector(interp, argv.getParseObj(name));
+
+    if (! vector)
+      std::cerr << "Invalid vector for '-" << name.toStdString() << "'\n";
+
+    return vector;
+  };
+
+  //---
+
+  // info and reduce return values
+  if      (argv.hasParseArg("info")) {
+    auto *vector = getVector("info");
+    if (! vector) return false;
+
+    QVariantList shape;
+
+    for (const auto &d : vector->shape())
+      shape << QVariant(d);
+
+    QVariantList vars;
+
+    vars << QVariant(CTclVector::typeName(vector->type()));
+    vars << QVariant(shape);
+    vars << QVariant(int(vector->size()));
+
+    return frame_->setCmdRc(vars);
+  }
+  else if (argv.hasParseArg("reduce")) {
+    auto *vector = getVector("reduce");
+    if (! vector) return false;
+
+    auto op = argv.getParseStr("op", "sum");
+
+    CTclVector::Reduce reduce;
+
+    if      (op == "sum" ) reduce = CTclVector::Reduce::Sum;
+    else if (op == "min" ) reduce = CTclVector::Reduce::Min;
+    else if (op == "max" ) reduce = CTclVector::Reduce::Max;
+    else if (op == "mean") reduce = CTclVector::Reduce::Mean;
+    else {
+      std::cerr << "Invalid op '" << op.toStdString() << "'\n";
+      return false;
+    }
+
+    return frame_->setCmdRc(CTclVector::reduce(vector, reduce));
+  }
+
+  //---
+
+  // values, range and slice create new vector
+  CTclVector::Vector *vector = nullptr;
+
+  if      (argv.hasParseArg("values")) {
+    auto *vector1 = getVector("values");
+    if (! vector1) return false;
 
-  if (! widget->setNameValue(name, value))
+    vector = vector1->slice(0, vector1->size());
+  }
+  else if (argv.hasParseArg("range")) {
+    auto *range = getVector("range");
+    if (! range) return false;
+
+    if (range->size() < 2 || range->size() > 3) {
+      std::cerr << "Invalid range (expect start end ?step?)\n";
+      return false;
+    }
+
+    double start = range->value(0);
+    double end   = range->value(1);
+    double step  = (range->size() > 2 ? range->value(2) : 1.0);
+
+    if (step == 0.0 || (end - start)/step < 0.0) {
+      std::cerr << "Invalid range step\n";
+      return false;
+    }
+
+    auto n = size_t(std::ceil((end - start)/step));
+
+    vector = new CTclVector::Vector(CTclVector::Type::Real, n);
+
+    for (size_t i = 0; i < n; ++i)
+      vector->setValue(i, start + double(i)*step);
+  }
+  else if (argv.hasParseArg("slice")) {
+    auto *vector1 = getVector("slice");
+    if (! vector1) return false;
+
+    int start = argv.getParseInt("start", 0);
+    int end   = argv.getParseInt("end"  , int(vector1->size()));
+    int step  = argv.getParseInt("step" , 1);
+
+    if (start < 0 || end < 0 || step <= 0) {
+      std::cerr << "Invalid slice\n";
+      return false;
+    }
+
+    vector = vector1->slice(size_t(start), size_t(end), size_t(step));
+  }
+
+  if (! vector)
     return false;
 
+  vector->incRef();
+
+  //---
+
+  if (argv.hasParseArg("type")) {
+    auto typeStr = argv.getParseStr("type");
+
+    CTclVector::Type type;
+
+    if (! CTclVector::nameToType(typeStr.toLatin1().constData(), type)) {
+      std::cerr << "Invalid type '" << typeStr.toStdString() << "'\n";
+      vector->decRef();
+      return false;
+    }
+
+    if (type != vector->type()) {
+      auto *vector1 = vector->convert(type);
+
+      vector1->incRef();
+      vector ->decRef();
+
+      vector = vector1;
+    }
+  }
+
+  if (argv.hasParseArg("shape")) {
+    auto *shapeVector = getVector("shape");
+
+    CTclVector::Shape shape;
+
+    if (shapeVector) {
+      for (size_t i = 0; i < shapeVector->size(); ++i)
+        shape.push_back(int(shapeVector->value(i)));
+    }
+
+    if (! shapeVector || ! vector->setShape(shape)) {
+      std::cerr << "Invalid shape for " << vector->size() << " values\n";
+      vector->decRef();
+      return false;
+    }
+  }
+
+  //---
+
+  frame_->setCmdRc(CTclVector::newObj(vector));
+
+  vector->decRef();
+
+  return true;
+}
+
+//---
+
+void
+ProfileTclCmd::
+addArgs(CQTclCmd::CmdArgs &argv)
+{
+  argv.startCmdGroup(CQTclCmd::CmdGroup::Type::OneReq);
+  addArg(argv, "-start", ArgType::Boolean, "start profiling");
+  addArg(argv, "-stop" , ArgType::Boolean, "stop profiling");
+  addArg(argv, "-reset", ArgType::Boolean, "reset profile data");
+  addArg(argv, "-dump" , ArgType::Boolean, "dump profile data table");
+  addArg(argv, "-raster_cache"   , ArgType::SBool, "enable/disable cell pixmap cache");
+  addArg(argv, "-raster_cache_mb", ArgType::Real , "cell pixmap cache budget (MB)");
+  argv.endCmdGroup();
+}
+
+QStringList
+ProfileTclCmd::
+getArgValues(const QString &, const NameValueMap &)
+{
+  return QStringList();
+}
+
+bool
+ProfileTclCmd::
+exec(CQTclCmd::CmdArgs &argv)
+{
+  bool rc;
+
+  if (! argv.parse(rc))
+    return rc;
+
+  //---
+
+  auto *mgr = frame_->tclCmdMgr();
+
+  if      (argv.getParseBool("start"))
+    mgr->setProfiling(true);
+  else if (argv.getParseBool("stop"))
+    mgr->setProfiling(false);
+  else if (argv.getParseBool("reset")) {
+    mgr->resetProfile();
+
+    frame_->scheduler()->resetStats();
+  }
+  else if (argv.hasParseArg("raster_cache")) {
+    bool ok;
+
+    bool b = Frame::s_stringToBool(argv.getParseStr("raster_cache"), &ok);
+
+    if (! ok) {
+      std::cerr << "Invalid boolean for '-raster_cache'\n";
+      return false;
+    }
+
+    RasterCache::instance()->setEnabled(b);
+  }
+  else if (argv.hasParseArg("raster_cache_mb")) {
+    double mb = argv.getParseReal("raster_cache_mb");
+
+    if (mb < 0.0) {
+      std::cerr << "Invalid raster cache budget\n";
+      return false;
+    }
+
+    RasterCache::instance()->setMaxBytes(qint64(mb*1024*1024));
+  }
+  else if (argv.getParseBool("dump")) {
+    // called commands, most total time first
+    using Procs = std::vector<CQTclCmd::CmdProc *>;
+
+    Procs procs;
+
+    for (const auto &name : mgr->commandNames()) {
+      auto *proc = mgr->getCommand(name);
+
+      if (proc && proc->stats().count() > 0)
+        procs.push_back(proc);
+    }
+
+    std::sort(procs.begin(), procs.end(),
+      [](CQTclCmd::CmdProc *lhs, CQTclCmd::CmdProc *rhs) {
+        return lhs->stats().totalNs() > rhs->stats().totalNs();
+      });
+
+    //---
+
+    // result starting with html tag is displayed as html table
+    auto msStr = [](int64_t ns) { return QString::number(double(ns)/1e6, 'f', 3); };
+
+    QString html = "<html><table border=\"1\" cellpadding=\"2\">\n";
+
+    html += "<tr><th>Command</th><th>Calls</th><th>Total (ms)</th><th>Mean (ms)</th>"
+            "<th>Min (ms)</th><th>Max (ms)</th><th>Parse (ms)</th><th>Exec (ms)</th></tr>\n";
+
+    for (auto *proc : procs) {
+      const auto &stats = proc->stats();
+
+      auto count = stats.count();
+
+      html += "<tr><td>" + proc->name() + "</td>";
+      html += "<td align=\"right\">" + QString::number(count) + "</td>";
+      html += "<td align=\"right\">" + msStr(stats.totalNs()) + "</td>";
+      html += "<td align=\"right\">" + msStr(stats.totalNs()/count) + "</td>";
+      html += "<td align=\"right\">" + msStr(stats.minNs()) + "</td>";
+      html += "<td align=\"right\">" + msStr(stats.maxNs()) + "</td>";
+      html += "<td align=\"right\">" + msStr(stats.parseNs()) + "</td>";
+      html += "<td align=\"right\">" + msStr(stats.execNs()) + "</td></tr>\n";
+    }
+
+    html += "</table>\n";
+
+    //---
+
+    // layout/repaint requests run and merged by scheduler
+    auto *scheduler = frame_->scheduler();
+
+    html += "<table border=\"1\" cellpadding=\"2\">\n";
+
+    html += "<tr><th>Scheduler</th><th>Run</th><th>Merged</th></tr>\n";
+
+    html += "<tr><td>Layout</td>";
+    html += "<td align=\"right\">" + QString::number(scheduler->numLayouts()) + "</td>";
+    html += "<td align=\"right\">" + QString::number(scheduler->numSkipped()) + "</td></tr>\n";
+
+    html += "<tr><td>Repaint</td>";
+    html += "<td align=\"right\">" + QString::number(scheduler->numUpdates()) + "</td>";
+    html += "<td align=\"right\">" + QString::number(scheduler->numUpdatesSkipped()) +
+            "</td></tr>\n";
+
+    html += "</table>\n";
+
+    //---
+
+    // cell pixmap cache memory
+    auto *rasterCache = RasterCache::instance();
+
+    auto mbStr = [](qint64 n) { return QString::number(double(n)/(1024*1024), 'f', 1); };
+
+    html += "<table border=\"1\" cellpadding=\"2\">\n";
+
+    html += "<tr><th>Raster Cache</th><th>Used (MB)</th><th>Max (MB)</th></tr>\n";
+
+    html += "<tr><td>" + QString(rasterCache->isEnabled() ? "On" : "Off") + "</td>";
+    html += "<td align=\"right\">" + mbStr(rasterCache->usedBytes()) + "</td>";
+    html += "<td align=\"right\">" + mbStr(rasterCache->maxBytes()) + "</td></tr>\n";
+
+    html += "</table></html>";
+
+    return frame_->setCmdRc(html);
+  }
+
   return true;
 }
 
@@ -25,6 +25,10 @@ CQDataFrameHtml.cpp \
 CQDataFrameImage.cpp \
 CQDataFrameMarkdown.cpp \
 CQDataFrameSVG.cpp \
+CQDataFrameScheduler.cpp \
+CQDataFrameRasterCache.cpp \
+CQDataFrameMemoryMgr.cpp \
+CQDataFrameReactiveMgr.cpp \
 CQDataFrameTclCmd.cpp \
 CQDataFrameTcl.cpp \
 CQDataFrameText.cpp \
@@ -36,6 +40,10 @@ CSVGUtil.cpp \
 CQTclCmd.cpp \
 CTclUtil.cpp \
 CTclParse.cpp \
+CTclIncrParse.cpp \
+CTclScanner.cpp \
+CTclScan.cpp \
+CTclVector.cpp \
 
 HEADERS += \
 ../include/CQDataFrame.h \
@@ -50,6 +58,10 @@ HEADERS += \
 ../include/CQDataFrameImage.h \
 ../include/CQDataFrameMarkdown.h \
 ../include/CQDataFrameSVG.h \
+../include/CQDataFrameScheduler.h \
+../include/CQDataFrameRasterCache.h \
+../include/CQDataFrameMemoryMgr.h \
+../include/CQDataFrameReactiveMgr.h \
 ../include/CQDataFrameTclCmd.h \
 ../include/CQDataFrameTcl.h \
 ../include/CQDataFrameText.h \
@@ -61,6 +73,10 @@ HEADERS += \
 ../include/CQTclCmd.h \
 ../include/CQTclUtil.h \
 ../include/CTclUtil.h \
+../include/CTclIncrParse.h \
+../include/CTclScanner.h \
+../include/CTclScan.h \
+../include/CTclVector.h \
 
 DESTDIR     = ../lib
 OBJECTS_DIR = ../obj
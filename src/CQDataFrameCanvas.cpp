@@ -1,14 +1,737 @@
 #include <CQDataFrameCanvas.h>
 
 #include <CSVGUtil.h>
+#include <CTclVector.h>
 
 #include <QPainter>
+#include <QDataStream>
 #include <QPainterPath>
+#include <QMenu>
+#include <QHash>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
 
 namespace CQDataFrame {
 
 CanvasWidget *s_canvas = nullptr;
 
+namespace {
+
+// max primitives submitted to painter in one call
+const int batchSize = 4096;
+
+// call draw for runs (at most batchSize) of primitives with same color
+template<typename DRAW>
+void drawColorRuns(int n, const CanvasDisplayList::Colors *colors, DRAW draw)
+{
+  int i = 0;
+
+  while (i < n) {
+    int j = i + 1;
+
+    while (j < n && j - i < batchSize && (! colors || (*colors)[j] == (*colors)[i]))
+      ++j;
+
+    draw(i, j, colors ? &(*colors)[i] : nullptr);
+
+    i = j;
+  }
+}
+
+}
+
+//---
+
+qint64
+CanvasDisplayList::
+bytes() const
+{
+  qint64 n = qint64(items_.size()*sizeof(Item));
+
+  n += qint64(pens_   .size()*sizeof(QPen));
+  n += qint64(brushes_.size()*sizeof(QBrush));
+
+  for (const auto &path : paths_)
+    n += qint64(sizeof(QPainterPath)) + path.elementCount()*qint64(sizeof(QPainterPath::Element));
+
+  for (const auto &points : points_)
+    n += qint64(points.size()*sizeof(QPointF));
+
+  for (const auto &colors : colors_)
+    n += qint64(colors.size()*sizeof(QColor));
+
+  return n;
+}
+
+void
+CanvasDisplayList::
+clear()
+{
+  items_  .clear();
+  pens_   .clear();
+  brushes_.clear();
+  paths_  .clear();
+  points_ .clear();
+  colors_ .clear();
+
+  valid_       = false;
+  pixelCoords_ = false;
+}
+
+void
+CanvasDisplayList::
+setPen(const QPen &pen)
+{
+  Item item;
+
+  item.type = Type::PEN;
+  item.ind  = int(pens_.size());
+
+  pens_ .push_back(pen);
+  items_.push_back(item);
+}
+
+void
+CanvasDisplayList::
+setBrush(const QBrush &brush)
+{
+  Item item;
+
+  item.type = Type::BRUSH;
+  item.ind  = int(brushes_.size());
+
+  brushes_.push_back(brush);
+  items_  .push_back(item);
+}
+
+void
+CanvasDisplayList::
+addPath(const QPainterPath &path)
+{
+  Item item;
+
+  item.type = Type::PATH;
+  item.ind  = int(paths_.size());
+
+  paths_.push_back(path);
+  items_.push_back(item);
+}
+
+void
+CanvasDisplayList::
+addPixel(const QPointF &p, bool mapped)
+{
+  // consecutive pixels with same mapping share item
+  if (items_.empty() || items_.back().type != Type::PIXELS || items_.back().mapped != mapped) {
+    Item item;
+
+    item.type   = Type::PIXELS;
+    item.ind    = int(points_.size());
+    item.mapped = mapped;
+
+    points_.emplace_back();
+    items_ .push_back(item);
+  }
+
+  points_.back().push_back(p);
+}
+
+void
+CanvasDisplayList::
+addPoints(const Points &points, const Colors &colors, bool mapped)
+{
+  (void) addPointsItem(Type::POINTS, points, colors, int(points.size()), mapped);
+}
+
+void
+CanvasDisplayList::
+addPolyline(const Points &points, bool mapped)
+{
+  (void) addPointsItem(Type::POLYLINE, points, Colors(), int(points.size()), mapped);
+}
+
+void
+CanvasDisplayList::
+addRects(const Points &points, const Colors &colors, bool mapped)
+{
+  (void) addPointsItem(Type::RECTS, points, colors, int(points.size()/2), mapped);
+}
+
+void
+CanvasDisplayList::
+addMarkers(const Points &points, const Colors &colors, Symbol symbol, double size, bool mapped)
+{
+  auto &item = addPointsItem(Type::MARKERS, points, colors, int(points.size()), mapped);
+
+  item.symbol = symbol;
+  item.size   = size;
+}
+
+CanvasDisplayList::Item &
+CanvasDisplayList::
+addPointsItem(Type type, const Points &points, const Colors &colors, int n, bool mapped)
+{
+  Item item;
+
+  item.type   = type;
+  item.ind    = int(points_.size());
+  item.mapped = mapped;
+
+  points_.push_back(points);
+
+  // colors repeated to number of primitives
+  if (! colors.empty() && n > 0) {
+    item.colorInd = int(colors_.size());
+
+    colors_.emplace_back();
+
+    auto &colors1 = colors_.back();
+
+    colors1.resize(size_t(n));
+
+    for (int i = 0; i < n; ++i)
+      colors1[size_t(i)] = colors[size_t(i) % colors.size()];
+  }
+
+  items_.push_back(item);
+
+  return items_.back();
+}
+
+int
+CanvasDisplayList::
+numPrimitives(const Item &item) const
+{
+  int n = int(points_[item.ind].size());
+
+  return (item.type == Type::RECTS ? n/2 : n);
+}
+
+const CanvasDisplayList::Colors *
+CanvasDisplayList::
+itemColors(const Item &item) const
+{
+  return (item.colorInd >= 0 ? &colors_[item.colorInd] : nullptr);
+}
+
+void
+CanvasDisplayList::
+draw(QPainter *painter, const DisplayRange &displayRange) const
+{
+  // window to pixel is linear so paths are mapped by equivalent transform
+  // (geometry only, so pen widths are not scaled)
+  QTransform transform;
+
+  if (! isPixelCoords()) {
+    double px0, py0, px1, py1, px2, py2;
+
+    displayRange.windowToPixel(0.0, 0.0, &px0, &py0);
+    displayRange.windowToPixel(1.0, 0.0, &px1, &py1);
+    displayRange.windowToPixel(0.0, 1.0, &px2, &py2);
+
+    transform = QTransform(px1 - px0, py1 - py0, px2 - px0, py2 - py0, px0, py0);
+  }
+
+  QPolygon ipoints;
+  Points   buffer;
+
+  for (const auto &item : items_) {
+    switch (item.type) {
+      case Type::PEN:
+        painter->setPen(pens_[item.ind]);
+        break;
+      case Type::BRUSH:
+        painter->setBrush(brushes_[item.ind]);
+        break;
+      case Type::PATH:
+        if (isPixelCoords())
+          painter->drawPath(paths_[item.ind]);
+        else
+          painter->drawPath(transform.map(paths_[item.ind]));
+        break;
+      case Type::PIXELS: {
+        const auto &points = points_[item.ind];
+
+        ipoints.resize(int(points.size()));
+
+        int i = 0;
+
+        for (const auto &p : points) {
+          if (item.mapped) {
+            double px, py;
+
+            displayRange.windowToPixel(p.x(), p.y(), &px, &py);
+
+            ipoints[i++] = QPoint(int(px), int(py));
+          }
+          else
+            ipoints[i++] = QPoint(int(p.x()), int(p.y()));
+        }
+
+        painter->drawPoints(ipoints);
+
+        break;
+      }
+      case Type::POINTS:
+        drawPoints(painter, item, numPrimitives(item), mapPoints(item, displayRange, buffer),
+                   itemColors(item));
+        break;
+      case Type::POLYLINE:
+        painter->drawPolyline(mapPoints(item, displayRange, buffer),
+                              int(points_[item.ind].size()));
+        break;
+      case Type::RECTS:
+        drawRects(painter, item, numPrimitives(item), mapPoints(item, displayRange, buffer),
+                  itemColors(item));
+        break;
+      case Type::MARKERS:
+        drawMarkers(painter, item, numPrimitives(item), mapPoints(item, displayRange, buffer),
+                    itemColors(item));
+        break;
+    }
+  }
+}
+
+void
+CanvasDisplayList::
+mapToPixels(const DisplayRange &displayRange, CanvasDisplayList &pixelList) const
+{
+  pixelList = *this;
+
+  pixelList.pixelCoords_ = true;
+
+  if (isPixelCoords())
+    return;
+
+  double px0, py0, px1, py1, px2, py2;
+
+  displayRange.windowToPixel(0.0, 0.0, &px0, &py0);
+  displayRange.windowToPixel(1.0, 0.0, &px1, &py1);
+  displayRange.windowToPixel(0.0, 1.0, &px2, &py2);
+
+  QTransform transform(px1 - px0, py1 - py0, px2 - px0, py2 - py0, px0, py0);
+
+  for (auto &path : pixelList.paths_)
+    path = transform.map(path);
+
+  for (auto &item : pixelList.items_) {
+    if (item.ind < 0 || ! item.mapped)
+      continue;
+
+    if (item.type == Type::PIXELS || item.type == Type::POINTS || item.type == Type::POLYLINE ||
+        item.type == Type::RECTS  || item.type == Type::MARKERS) {
+      double px, py;
+
+      for (auto &p : pixelList.points_[item.ind]) {
+        displayRange.windowToPixel(p.x(), p.y(), &px, &py);
+
+        p = QPointF(px, py);
+      }
+
+      item.mapped = false;
+    }
+  }
+}
+
+void
+CanvasDisplayList::
+binTiles(int tileSize, int nx, int ny, TileBins &bins) const
+{
+  assert(isPixelCoords());
+
+  bins.clear();
+  bins.resize(size_t(nx*ny));
+
+  // current pen/brush items and pen/brush items last added to each bin (pen/brush
+  // only added to a bin before an item is drawn in it, so cost is per drawn entry)
+  int penItem   = -1;
+  int brushItem = -1;
+
+  std::vector<int> binPens   (size_t(nx*ny), -1);
+  std::vector<int> binBrushes(size_t(nx*ny), -1);
+
+  // add item (or item primitive) to bins of tiles overlapping pixel rect
+  auto addRect = [&](int itemInd, int prim, const QRectF &rect) {
+    double x1 = rect.left(), y1 = rect.top(), x2 = rect.right(), y2 = rect.bottom();
+
+    if (! std::isfinite(x1) || ! std::isfinite(y1) || ! std::isfinite(x2) || ! std::isfinite(y2))
+      return;
+
+    if (x2 < 0 || y2 < 0 || x1 >= nx*tileSize || y1 >= ny*tileSize)
+      return;
+
+    // (clamp to image before int conversion)
+    int tx1 = int(std::max(x1, 0.0))/tileSize, tx2 = int(std::min(x2, nx*tileSize - 1.0))/tileSize;
+    int ty1 = int(std::max(y1, 0.0))/tileSize, ty2 = int(std::min(y2, ny*tileSize - 1.0))/tileSize;
+
+    for (int ty = ty1; ty <= ty2; ++ty) {
+      for (int tx = tx1; tx <= tx2; ++tx) {
+        size_t b = size_t(ty*nx + tx);
+
+        auto &entries = bins[b].entries;
+
+        if (binPens[b] != penItem) {
+          entries.emplace_back();
+
+          entries.back().item = penItem;
+
+          binPens[b] = penItem;
+        }
+
+        if (binBrushes[b] != brushItem) {
+          entries.emplace_back();
+
+          entries.back().item = brushItem;
+
+          binBrushes[b] = brushItem;
+        }
+
+        if (entries.empty() || entries.back().item != itemInd) {
+          entries.emplace_back();
+
+          entries.back().item = itemInd;
+        }
+
+        if (prim >= 0)
+          entries.back().prims.push_back(prim);
+      }
+    }
+  };
+
+  // margin for pen (half width plus square caps and miter joins) and antialiasing
+  double m = 2.0;
+
+  int numItems = int(items_.size());
+
+  for (int i = 0; i < numItems; ++i) {
+    const auto &item = items_[size_t(i)];
+
+    switch (item.type) {
+      case Type::PEN:
+        m = std::max(pens_[item.ind].widthF(), 1.0) + 1.0;
+
+        penItem = i;
+
+        break;
+      case Type::BRUSH:
+        brushItem = i;
+
+        break;
+      case Type::PATH:
+        addRect(i, -1, paths_[item.ind].controlPointRect().adjusted(-m, -m, m, m));
+
+        break;
+      case Type::PIXELS: {
+        int k = 0;
+
+        for (const auto &p : points_[item.ind])
+          addRect(i, k++, QRectF(p.x() - 1.0, p.y() - 1.0, 2.0, 2.0));
+
+        break;
+      }
+      case Type::POINTS: {
+        int k = 0;
+
+        for (const auto &p : points_[item.ind])
+          addRect(i, k++, QRectF(p.x() - m, p.y() - m, 2*m, 2*m));
+
+        break;
+      }
+      case Type::POLYLINE: {
+        // polyline drawn whole (joins) so binned by bounding box
+        const auto &points = points_[item.ind];
+
+        if (points.empty())
+          break;
+
+        QRectF rect(points[0], points[0]);
+
+        for (const auto &p : points) {
+          rect.setLeft  (std::min(rect.left  (), p.x()));
+          rect.setTop   (std::min(rect.top   (), p.y()));
+          rect.setRight (std::max(rect.right (), p.x()));
+          rect.setBottom(std::max(rect.bottom(), p.y()));
+        }
+
+        addRect(i, -1, rect.adjusted(-m, -m, m, m));
+
+        break;
+      }
+      case Type::RECTS: {
+        const auto &points = points_[item.ind];
+
+        int n = numPrimitives(item);
+
+        for (int k = 0; k < n; ++k)
+          addRect(i, k, QRectF(points[2*k], points[2*k + 1]).normalized().adjusted(-m, -m, m, m));
+
+        break;
+      }
+      case Type::MARKERS: {
+        double s = item.size/2.0 + m;
+
+        int k = 0;
+
+        for (const auto &p : points_[item.ind])
+          addRect(i, k++, QRectF(p.x() - s, p.y() - s, 2*s, 2*s));
+
+        break;
+      }
+    }
+  }
+}
+
+void
+CanvasDisplayList::
+drawBin(QPainter *painter, const TileBin &bin, Paths &paths) const
+{
+  assert(isPixelCoords());
+
+  paths.resize(paths_.size());
+
+  QPolygon ipoints;
+  Points   points;
+  Colors   colors;
+
+  for (const auto &entry : bin.entries) {
+    const auto &item = items_[size_t(entry.item)];
+
+    switch (item.type) {
+      case Type::PEN:
+        painter->setPen(pens_[item.ind]);
+        break;
+      case Type::BRUSH:
+        painter->setBrush(brushes_[item.ind]);
+        break;
+      case Type::PATH: {
+        // deep copy on first use (not shared with other threads)
+        auto &path = paths[size_t(item.ind)];
+
+        if (path.isEmpty()) {
+          path.addPath(paths_[item.ind]);
+
+          path.setFillRule(paths_[item.ind].fillRule());
+        }
+
+        painter->drawPath(path);
+
+        break;
+      }
+      case Type::PIXELS: {
+        const auto &points1 = points_[item.ind];
+
+        ipoints.resize(int(entry.prims.size()));
+
+        int i = 0;
+
+        for (auto k : entry.prims)
+          ipoints[i++] = QPoint(int(points1[size_t(k)].x()), int(points1[size_t(k)].y()));
+
+        painter->drawPoints(ipoints);
+
+        break;
+      }
+      case Type::POINTS: {
+        const auto *colors1 = binPoints(item, entry.prims, points, colors);
+
+        drawPoints(painter, item, int(entry.prims.size()), points.data(), colors1);
+
+        break;
+      }
+      case Type::POLYLINE:
+        painter->drawPolyline(points_[item.ind].data(), int(points_[item.ind].size()));
+        break;
+      case Type::RECTS: {
+        const auto *colors1 = binPoints(item, entry.prims, points, colors);
+
+        drawRects(painter, item, int(entry.prims.size()), points.data(), colors1);
+
+        break;
+      }
+      case Type::MARKERS: {
+        const auto *colors1 = binPoints(item, entry.prims, points, colors);
+
+        drawMarkers(painter, item, int(entry.prims.size()), points.data(), colors1);
+
+        break;
+      }
+    }
+  }
+}
+
+const CanvasDisplayList::Colors *
+CanvasDisplayList::
+binPoints(const Item &item, const std::vector<int> &prims, Points &points, Colors &colors) const
+{
+  const auto &points1 = points_[item.ind];
+  const auto *colors1 = itemColors(item);
+
+  // rects have two points per primitive
+  size_t np = (item.type == Type::RECTS ? 2 : 1);
+
+  points.resize(np*prims.size());
+
+  size_t i = 0;
+
+  for (auto k : prims) {
+    for (size_t j = 0; j < np; ++j)
+      points[i++] = points1[np*size_t(k) + j];
+  }
+
+  if (! colors1)
+    return nullptr;
+
+  colors.resize(prims.size());
+
+  i = 0;
+
+  for (auto k : prims)
+    colors[i++] = (*colors1)[size_t(k)];
+
+  return &colors;
+}
+
+const QPointF *
+CanvasDisplayList::
+mapPoints(const Item &item, const DisplayRange &displayRange, Points &buffer) const
+{
+  const auto &points = points_[item.ind];
+
+  if (! item.mapped)
+    return points.data();
+
+  size_t n = points.size();
+
+  buffer.resize(n);
+
+  double px, py;
+
+  for (size_t i = 0; i < n; ++i) {
+    displayRange.windowToPixel(points[i].x(), points[i].y(), &px, &py);
+
+    buffer[i] = QPointF(px, py);
+  }
+
+  return buffer.data();
+}
+
+void
+CanvasDisplayList::
+drawPoints(QPainter *painter, const Item &, int n, const QPointF *ppoints,
+           const Colors *colors) const
+{
+  auto pen = painter->pen();
+
+  drawColorRuns(n, colors, [&](int i, int j, const QColor *c) {
+    if (c) {
+      auto pen1 = pen;
+
+      pen1.setColor(*c);
+
+      painter->setPen(pen1);
+    }
+
+    painter->drawPoints(ppoints + i, j - i);
+  });
+
+  painter->setPen(pen);
+}
+
+void
+CanvasDisplayList::
+drawRects(QPainter *painter, const Item &, int n, const QPointF *ppoints,
+          const Colors *colors) const
+{
+  auto brush = painter->brush();
+
+  std::vector<QRectF> rects;
+
+  drawColorRuns(n, colors, [&](int i, int j, const QColor *c) {
+    if (c)
+      painter->setBrush(*c);
+
+    rects.resize(size_t(j - i));
+
+    for (int k = i; k < j; ++k)
+      rects[size_t(k - i)] = QRectF(ppoints[2*k], ppoints[2*k + 1]).normalized();
+
+    painter->drawRects(rects.data(), j - i);
+  });
+
+  painter->setBrush(brush);
+}
+
+void
+CanvasDisplayList::
+drawMarkers(QPainter *painter, const Item &item, int n, const QPointF *ppoints,
+            const Colors *colors) const
+{
+  auto pen   = painter->pen();
+  auto brush = painter->brush();
+
+  double s = item.size/2.0;
+
+  std::vector<QRectF> rects;
+  std::vector<QLineF> lines;
+
+  drawColorRuns(n, colors, [&](int i, int j, const QColor *c) {
+    // cross and plus are lines so color is stroke color
+    bool isLine = (item.symbol == Symbol::CROSS || item.symbol == Symbol::PLUS);
+
+    if (c) {
+      if (isLine) {
+        auto pen1 = pen;
+
+        pen1.setColor(*c);
+
+        painter->setPen(pen1);
+      }
+      else
+        painter->setBrush(*c);
+    }
+
+    if      (item.symbol == Symbol::CIRCLE) {
+      for (int k = i; k < j; ++k)
+        painter->drawEllipse(ppoints[k], s, s);
+    }
+    else if (item.symbol == Symbol::SQUARE) {
+      rects.resize(size_t(j - i));
+
+      for (int k = i; k < j; ++k)
+        rects[size_t(k - i)] = QRectF(ppoints[k].x() - s, ppoints[k].y() - s, 2*s, 2*s);
+
+      painter->drawRects(rects.data(), j - i);
+    }
+    else {
+      lines.resize(size_t(2*(j - i)));
+
+      for (int k = i; k < j; ++k) {
+        double x = ppoints[k].x(), y = ppoints[k].y();
+
+        auto l = size_t(2*(k - i));
+
+        if (item.symbol == Symbol::CROSS) {
+          lines[l    ] = QLineF(x - s, y - s, x + s, y + s);
+          lines[l + 1] = QLineF(x - s, y + s, x + s, y - s);
+        }
+        else {
+          lines[l    ] = QLineF(x - s, y, x + s, y);
+          lines[l + 1] = QLineF(x, y - s, x, y + s);
+        }
+      }
+
+      painter->drawLines(lines.data(), int(lines.size()));
+    }
+  });
+
+  painter->setPen  (pen);
+  painter->setBrush(brush);
+}
+
+//------
+
 CanvasWidget::
 CanvasWidget(Area *area, int width, int height) :
  Widget(area)
@@ -56,6 +779,8 @@ getNameValue(const QString &name, QVariant &value) const
     else if (name == "xmax") value = xmax();
     else if (name == "ymax") value = ymax();
   }
+  else if (name == "threads")
+    value = numThreads();
   else
     return Widget::getNameValue(name, value);
 
@@ -77,6 +802,11 @@ setNameValue(const QString &name, const QVariant &value)
     if (ok)
       setWindowRange();
   }
+  else if (name == "threads") {
+    setNumThreads(value.toInt(&ok));
+
+    dirty_ = true;
+  }
   else
     return Widget::setNameValue(name, value);
 
@@ -86,6 +816,44 @@ setNameValue(const QString &name, const QVariant &value)
   return true;
 }
 
+void
+CanvasWidget::
+setDrawProc(const QString &s)
+{
+  drawProc_ = s;
+
+  invalidate();
+}
+
+void
+CanvasWidget::
+invalidate()
+{
+  displayList_.setValid(false);
+
+  dirty_ = true;
+
+  contentsUpdateSlot();
+}
+
+void
+CanvasWidget::
+redrawSlot()
+{
+  invalidate();
+}
+
+void
+CanvasWidget::
+addMenuItems(QMenu *menu)
+{
+  Widget::addMenuItems(menu);
+
+  auto *redrawAction = menu->addAction("Redraw");
+
+  connect(redrawAction, SIGNAL(triggered()), this, SLOT(redrawSlot()));
+}
+
 void
 CanvasWidget::
 updateSize()
@@ -94,10 +862,12 @@ updateSize()
   int ih = contentsHeight();
 
   if (iw != image_.width() || ih != image_.height()) {
-    image_ = QImage(iw, ih, QImage::Format_ARGB32);
+    image_ = QImage(iw, ih, QImage::Format_ARGB32_Premultiplied);
 
     displayRange_.setPixelRange(0, 0, iw, ih);
 
+    invalidatePixelList();
+
     dirty_ = true;
   }
 }
@@ -108,6 +878,8 @@ setWindowRange()
 {
   displayRange_.setWindowRange(xmin(), ymin(), xmax(), ymax());
 
+  invalidatePixelList();
+
   dirty_ = true;
 }
 
@@ -119,39 +891,138 @@ draw(QPainter *painter, int dx, int dy)
     return;
 
   if (dirty_) {
-    ipainter_ = new QPainter;
+    // draw proc only run if display list invalidated (replayed for size/range change)
+    if (! displayList_.isValid())
+      recordDisplayList();
+
+    renderImage();
+
+    dirty_ = false;
+  }
+
+  painter->drawImage(dx, dy, image_);
+}
+
+void
+CanvasWidget::
+renderImage()
+{
+  // tiles rendered in parallel from display list mapped to pixels and binned by
+  // tile (each tile painter draws its own items to its own region of image memory)
+  const int tileSize = 256;
+
+  int iw = image_.width ();
+  int ih = image_.height();
+
+  int nx = (iw + tileSize - 1)/tileSize;
+  int ny = (ih + tileSize - 1)/tileSize;
+
+  int numThreads = numThreads_;
+
+  if (numThreads <= 0)
+    numThreads = std::max(int(std::thread::hardware_concurrency()), 1);
+
+  numThreads = std::min(numThreads, nx*ny);
+
+  if (numThreads <= 1) {
+    QPainter ipainter(&image_);
+
+    ipainter.fillRect(QRect(0, 0, iw, ih), bgColor_);
+
+    displayList_.draw(&ipainter, displayRange_);
+
+    return;
+  }
+
+  // pixel list and bins reused until display list, range or size changes
+  if (! pixelListValid_) {
+    displayList_.mapToPixels(displayRange_, pixelList_);
 
-    ipainter_->begin(&image_);
+    pixelList_.binTiles(tileSize, nx, ny, tileBins_);
 
-    ipainter_->fillRect(QRect(0, 0, image_.width(), image_.height()), bgColor_);
+    pixelListValid_ = true;
+  }
+
+  // get bits once (detach) before threads share image
+  uchar *bits         = image_.bits();
+  int    bytesPerLine = image_.bytesPerLine();
+
+  std::atomic<int> nextTile { 0 };
+
+  auto renderTiles = [&]() {
+    // own copies of paths drawn by this thread
+    CanvasDisplayList::Paths paths;
 
-    auto *frame = this->frame();
+    int i;
 
-    s_canvas = this;
+    while ((i = nextTile++) < nx*ny) {
+      QRect rect((i % nx)*tileSize, (i / nx)*tileSize, tileSize, tileSize);
 
-    ipainter_->setPen  (Qt::red);
-    ipainter_->setBrush(Qt::green);
+      rect = rect.intersected(QRect(0, 0, iw, ih));
 
-    if (drawProc_ != "") {
-      auto *qtcl = frame->qtcl();
+      QImage tileImage(bits + rect.y()*bytesPerLine + rect.x()*4, rect.width(), rect.height(),
+                       bytesPerLine, QImage::Format_ARGB32_Premultiplied);
 
-      QString cmd = QString("%1 %2").arg(drawProc_).arg(id());
+      QPainter tpainter(&tileImage);
 
-      bool log = true;
+      tpainter.fillRect(QRect(0, 0, rect.width(), rect.height()), bgColor_);
 
-      (void) qtcl->eval(cmd, /*showError*/true, /*showResult*/log);
+      tpainter.translate(-rect.x(), -rect.y());
+
+      pixelList_.drawBin(&tpainter, tileBins_[size_t(i)], paths);
     }
+  };
 
-    s_canvas = nullptr;
+  std::vector<std::thread> threads;
 
-    ipainter_->end();
+  for (int i = 1; i < numThreads; ++i)
+    threads.emplace_back(renderTiles);
 
-    delete ipainter_;
+  renderTiles();
 
-    dirty_ = false;
+  for (auto &thread : threads)
+    thread.join();
+}
+
+void
+CanvasWidget::
+invalidatePixelList()
+{
+  pixelList_.clear();
+
+  tileBins_.clear();
+
+  pixelListValid_ = false;
+}
+
+void
+CanvasWidget::
+recordDisplayList()
+{
+  displayList_.clear();
+
+  invalidatePixelList();
+
+  displayList_.setPen  (QPen(Qt::red));
+  displayList_.setBrush(QBrush(Qt::green));
+
+  if (drawProc_ != "") {
+    auto *qtcl = frame()->qtcl();
+
+    QString cmd = QString("%1 %2").arg(drawProc_).arg(id());
+
+    s_canvas   = this;
+    recording_ = true;
+
+    bool log = true;
+
+    (void) qtcl->eval(cmd, /*showError*/true, /*showResult*/log);
+
+    s_canvas   = nullptr;
+    recording_ = false;
   }
 
-  painter->drawImage(dx, dy, image_);
+  displayList_.setValid(true);
 }
 
 QSize
@@ -168,36 +1039,76 @@ contentsSize() const
   return QSize(width(), height());
 }
 
+qint64
+CanvasWidget::
+payloadBytes() const
+{
+  // image, retained display list and its pixel mapped copy
+  return image_.sizeInBytes() + displayList_.bytes() + pixelList_.bytes();
+}
+
+bool
+CanvasWidget::
+writePayload(QDataStream &) const
+{
+  // image and display list regenerated from draw proc so nothing to save
+  return true;
+}
+
+void
+CanvasWidget::
+freePayload()
+{
+  image_ = QImage();
+
+  // display list is recorded again (by draw proc) on next draw
+  displayList_.clear();
+
+  invalidatePixelList();
+
+  dirty_ = true;
+}
+
+bool
+CanvasWidget::
+readPayload(QDataStream &)
+{
+  updateSize();
+
+  return true;
+}
+
 void
 CanvasWidget::
 setBrush(const QBrush &brush)
 {
-  assert(ipainter_);
+  assert(recording_);
 
-  ipainter_->setBrush(brush);
+  displayList_.setBrush(brush);
 }
 
 void
 CanvasWidget::
 setPen(const QPen &pen)
 {
-  assert(ipainter_);
+  assert(recording_);
 
-  ipainter_->setPen(pen);
+  displayList_.setPen(pen);
 }
 
 void
 CanvasWidget::
 drawPath(const QString &path)
 {
-  assert(ipainter_);
+  assert(recording_);
 
   //---
 
+  // path built in window coords (mapped to pixels on draw)
   class Visitor : public CSVGUtil::PathVisitor {
    public:
-    Visitor(QPainter *painter, const DisplayRange &displayRange) :
-     painter_(painter), displayRange_(displayRange) {
+    Visitor(CanvasDisplayList &displayList) :
+     displayList_(displayList) {
     }
 
     void moveTo(double x, double y) override {
@@ -237,25 +1148,20 @@ drawPath(const QString &path)
     }
 
     void term() override {
-      painter_->drawPath(path_);
+      displayList_.addPath(path_);
     }
 
    private:
     QPointF qpoint(const CPoint2D &p) {
-      double px, py;
-
-      displayRange_.windowToPixel(p.x, p.y, &px, &py);
-
-      return QPointF(px, py);
+      return QPointF(p.x, p.y);
     }
 
    private:
-    QPainter*    painter_ { nullptr };
-    DisplayRange displayRange_;
-    QPainterPath path_;
+    CanvasDisplayList &displayList_;
+    QPainterPath       path_;
   };
 
-  Visitor visitor(ipainter_, displayRange_);
+  Visitor visitor(displayList_);
 
   CSVGUtil::visitPath(path.toStdString(), visitor);
 }
@@ -264,19 +1170,45 @@ void
 CanvasWidget::
 drawPixel(const QPointF &p)
 {
-  assert(ipainter_);
+  assert(recording_);
 
-  double px, py;
+  displayList_.addPixel(p, isMapping());
+}
 
-  if (isMapping()) {
-    windowToPixel(p.x(), p.y(), &px, &py);
-  }
-  else {
-    px = p.x();
-    py = p.y();
-  }
+void
+CanvasWidget::
+drawPoints(const Points &points, const Colors &colors)
+{
+  assert(recording_);
+
+  displayList_.addPoints(points, colors, isMapping());
+}
+
+void
+CanvasWidget::
+drawPolyline(const Points &points)
+{
+  assert(recording_);
+
+  displayList_.addPolyline(points, isMapping());
+}
+
+void
+CanvasWidget::
+drawRects(const Points &points, const Colors &colors)
+{
+  assert(recording_);
+
+  displayList_.addRects(points, colors, isMapping());
+}
+
+void
+CanvasWidget::
+drawMarkers(const Points &points, const Colors &colors, Symbol symbol, double size)
+{
+  assert(recording_);
 
-  ipainter_->drawPoint(int(px), int(py));
+  displayList_.addMarkers(points, colors, symbol, size, isMapping());
 }
 
 void
@@ -315,8 +1247,6 @@ bool
 CanvasTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -364,15 +1294,27 @@ CanvasInstTclCmd::
 addArgs(CQTclCmd::CmdArgs &argv)
 {
   addArg(argv, "-path"   , ArgType::String, "path");
-  addArg(argv, "-pixel"  , ArgType::String, "pixel");
+  addArg(argv, "-pixel"  , ArgType::Object, "pixel");
+  addArg(argv, "-pixels" , ArgType::Object, "pixels {x1 y1 x2 y2 ...}");
+
+  addArg(argv, "-points"  , ArgType::Object, "points {x1 y1 x2 y2 ...}");
+  addArg(argv, "-polyline", ArgType::Object, "polyline {x1 y1 x2 y2 ...}");
+  addArg(argv, "-rects"   , ArgType::Object, "rects {x1 y1 x2 y2 ...} (corners)");
+  addArg(argv, "-markers" , ArgType::Object, "markers {x1 y1 x2 y2 ...}");
+
+  addArg(argv, "-colors", ArgType::String, "colors {c1 c2 ...} (per point, rect or marker)");
+  addArg(argv, "-symbol", ArgType::String, "marker symbol (circle, square, cross, plus)");
+  addArg(argv, "-size"  , ArgType::Real  , "marker size (pixels)");
 
   addArg(argv, "-fill"   , ArgType::String, "fill");
   addArg(argv, "-stroke" , ArgType::String, "stroke");
 
   addArg(argv, "-mapping", ArgType::SBool , "mapping enabled");
 
-  addArg(argv, "-pixel_to_window", ArgType::String , "pixel to window");
-  addArg(argv, "-window_to_pixel", ArgType::String , "window to pixel");
+  addArg(argv, "-pixel_to_window", ArgType::Object , "pixel to window");
+  addArg(argv, "-window_to_pixel", ArgType::Object , "window to pixel");
+
+  addArg(argv, "-invalidate", ArgType::Boolean, "rerun draw proc");
 }
 
 QStringList
@@ -382,17 +1324,76 @@ getArgValues(const QString &, const NameValueMap &)
   return QStringList();
 }
 
+namespace {
+
+// canvas instance command option slots
+// (all canvas instance commands have the same arguments so slots are looked up once)
+struct CanvasInstSlots {
+  CanvasInstSlots(const CQTclCmd::CmdArgs &argv) :
+   path         (argv.argSlot("path")),
+   pixel        (argv.argSlot("pixel")),
+   pixels       (argv.argSlot("pixels")),
+   points       (argv.argSlot("points")),
+   polyline     (argv.argSlot("polyline")),
+   rects        (argv.argSlot("rects")),
+   markers      (argv.argSlot("markers")),
+   colors       (argv.argSlot("colors")),
+   symbol       (argv.argSlot("symbol")),
+   size         (argv.argSlot("size")),
+   fill         (argv.argSlot("fill")),
+   stroke       (argv.argSlot("stroke")),
+   mapping      (argv.argSlot("mapping")),
+   pixelToWindow(argv.argSlot("pixel_to_window")),
+   windowToPixel(argv.argSlot("window_to_pixel")),
+   invalidate   (argv.argSlot("invalidate")) {
+  }
+
+  int path;
+  int pixel;
+  int pixels;
+  int points;
+  int polyline;
+  int rects;
+  int markers;
+  int colors;
+  int symbol;
+  int size;
+  int fill;
+  int stroke;
+  int mapping;
+  int pixelToWindow;
+  int windowToPixel;
+  int invalidate;
+};
+
+}
+
+//---
+
 bool
 CanvasInstTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
     return rc;
 
+  // options read by slot (no name lookup)
+  static CanvasInstSlots argSlots(argv);
+
+  //---
+
+  // invalidate (outside draw proc) reruns draw proc on next draw
+  if (argv.getSlotBool(argSlots.invalidate)) {
+    auto *canvas = qobject_cast<CanvasWidget *>(frame_->getWidget(id_));
+    if (! canvas) return false;
+
+    canvas->invalidate();
+
+    return true;
+  }
+
   //---
 
   auto *canvas = s_canvas;
@@ -400,10 +1401,10 @@ exec(CQTclCmd::CmdArgs &argv)
 
   //---
 
-  if (argv.hasParseArg("fill")) {
+  if (argv.hasParseSlot(argSlots.fill)) {
     QBrush brush(Qt::SolidPattern);
 
-    auto fill = argv.getParseStr("fill");
+    auto fill = argv.getSlotStr(argSlots.fill);
 
     QStringList fillStrs;
 
@@ -431,10 +1432,10 @@ exec(CQTclCmd::CmdArgs &argv)
 
     //---
 
-  if (argv.hasParseArg("stroke")) {
+  if (argv.hasParseSlot(argSlots.stroke)) {
     QPen pen(Qt::SolidLine);
 
-    auto stroke = argv.getParseStr("stroke");
+    auto stroke = argv.getSlotStr(argSlots.stroke);
 
     QStringList strokeStrs;
 
@@ -475,31 +1476,66 @@ exec(CQTclCmd::CmdArgs &argv)
 
   //---
 
-  auto argToPoint = [&](const QString &arg, QPointF &p) {
-    QStringList strs;
+  // get points from vector object (lists converted without string split)
+  auto *interp = frame_->qtcl()->interp();
 
-    CQTclUtil::splitList(arg, strs);
+  auto argToPoints = [&](int slot, const char *name) -> CTclVector::Vector * {
+    auto *vector = CTclVector::getVector(interp, argv.getSlotObj(slot));
 
-    if (strs.length() != 2)
-      return false;
+    if (! vector) {
+      std::cerr << "Invalid vector for '-" << name << "'\n";
+      return nullptr;
+    }
 
-    bool ok;
+    if (vector->size() % 2 != 0) {
+      std::cerr << "Invalid points for '-" << name << "' (expect x y pairs)\n";
+      return nullptr;
+    }
+
+    return vector;
+  };
+
+  // convert all vector values to points in one pass
+  auto argToPointList = [&](int slot, const char *name, CanvasWidget::Points &points) {
+    auto *vector = argToPoints(slot, name);
+    if (! vector) return false;
 
-    double x = strs[0].toDouble(&ok);
-    if (! ok) return false;
+    size_t n = vector->size()/2;
 
-    double y = strs[1].toDouble(&ok);
-    if (! ok) return false;
+    points.resize(n);
+
+    const auto *reals = vector->reals();
+
+    if (reals) {
+      for (size_t i = 0; i < n; ++i)
+        points[i] = QPointF(reals[2*i], reals[2*i + 1]);
+    }
+    else {
+      for (size_t i = 0; i < n; ++i)
+        points[i] = QPointF(vector->value(2*i), vector->value(2*i + 1));
+    }
+
+    return true;
+  };
+
+  auto argToPoint = [&](int slot, const char *name, QPointF &p) {
+    auto *vector = argToPoints(slot, name);
+    if (! vector) return false;
+
+    if (vector->size() != 2) {
+      std::cerr << "Invalid point for '-" << name << "' (expect x y)\n";
+      return false;
+    }
 
-    p = QPointF(x, y);
+    p = QPointF(vector->value(0), vector->value(1));
 
     return true;
   };
 
   //---
 
-  if (argv.hasParseArg("mapping")) {
-    auto str = argv.getParseStr("mapping");
+  if (argv.hasParseSlot(argSlots.mapping)) {
+    auto str = argv.getSlotStr(argSlots.mapping);
 
     bool ok;
 
@@ -507,27 +1543,113 @@ exec(CQTclCmd::CmdArgs &argv)
       canvas->setMapping(false);
   }
 
-  if      (argv.hasParseArg("path")) {
-    auto path = argv.getParseStr("path");
+  if      (argv.hasParseSlot(argSlots.path)) {
+    auto path = argv.getSlotStr(argSlots.path);
 
     canvas->drawPath(path);
   }
-  else if (argv.hasParseArg("pixel")) {
-    auto arg = argv.getParseStr("pixel");
-
+  else if (argv.hasParseSlot(argSlots.pixel)) {
     QPointF point;
 
-    if (! argToPoint(arg, point))
+    if (! argToPoint(argSlots.pixel, "pixel", point))
       return false;
 
     canvas->drawPixel(point);
   }
-  else if (argv.hasParseArg("pixel_to_window")) {
-    auto arg = argv.getParseStr("pixel_to_window");
+  else if (argv.hasParseSlot(argSlots.pixels)) {
+    auto *points = argToPoints(argSlots.pixels, "pixels");
+    if (! points) return false;
+
+    size_t n = points->size()/2;
+
+    for (size_t i = 0; i < n; ++i)
+      canvas->drawPixel(QPointF(points->value(2*i), points->value(2*i + 1)));
+  }
+  else if (argv.hasParseSlot(argSlots.points) || argv.hasParseSlot(argSlots.polyline) ||
+           argv.hasParseSlot(argSlots.rects ) || argv.hasParseSlot(argSlots.markers )) {
+    // optional per primitive colors (repeated names converted once)
+    CanvasWidget::Colors colors;
+
+    if (argv.hasParseSlot(argSlots.colors)) {
+      QStringList colorStrs;
+
+      CQTclUtil::splitList(argv.getSlotStr(argSlots.colors), colorStrs);
+
+      QHash<QString, QColor> colorMap;
+
+      colors.reserve(size_t(colorStrs.length()));
+
+      for (const auto &str : colorStrs) {
+        auto pc = colorMap.find(str);
+
+        if (pc == colorMap.end()) {
+          QColor c(str);
+
+          if (! c.isValid()) {
+            std::cerr << "Invalid color '" << str.toStdString() << "'\n";
+            return false;
+          }
+
+          pc = colorMap.insert(str, c);
+        }
+
+        colors.push_back(pc.value());
+      }
+    }
 
+    CanvasWidget::Points points;
+
+    if      (argv.hasParseSlot(argSlots.points)) {
+      if (! argToPointList(argSlots.points, "points", points))
+        return false;
+
+      canvas->drawPoints(points, colors);
+    }
+    else if (argv.hasParseSlot(argSlots.polyline)) {
+      if (! argToPointList(argSlots.polyline, "polyline", points))
+        return false;
+
+      canvas->drawPolyline(points);
+    }
+    else if (argv.hasParseSlot(argSlots.rects)) {
+      if (! argToPointList(argSlots.rects, "rects", points))
+        return false;
+
+      if (points.size() % 2 != 0) {
+        std::cerr << "Invalid rects (expect x1 y1 x2 y2 values)\n";
+        return false;
+      }
+
+      canvas->drawRects(points, colors);
+    }
+    else {
+      if (! argToPointList(argSlots.markers, "markers", points))
+        return false;
+
+      auto symbol = CanvasWidget::Symbol::CIRCLE;
+
+      if (argv.hasParseSlot(argSlots.symbol)) {
+        auto str = argv.getSlotStr(argSlots.symbol);
+
+        if      (str == "circle") symbol = CanvasWidget::Symbol::CIRCLE;
+        else if (str == "square") symbol = CanvasWidget::Symbol::SQUARE;
+        else if (str == "cross" ) symbol = CanvasWidget::Symbol::CROSS;
+        else if (str == "plus"  ) symbol = CanvasWidget::Symbol::PLUS;
+        else {
+          std::cerr << "Invalid symbol '" << str.toStdString() << "'\n";
+          return false;
+        }
+      }
+
+      double size = argv.getSlotReal(argSlots.size, 5.0);
+
+      canvas->drawMarkers(points, colors, symbol, size);
+    }
+  }
+  else if (argv.hasParseSlot(argSlots.pixelToWindow)) {
     QPointF point;
 
-    if (! argToPoint(arg, point))
+    if (! argToPoint(argSlots.pixelToWindow, "pixel_to_window", point))
       return false;
 
     double wx, wy;
@@ -541,12 +1663,10 @@ exec(CQTclCmd::CmdArgs &argv)
 
     frame_->setCmdRc(vars);
   }
-  else if (argv.hasParseArg("window_to_pixel")) {
-    auto arg = argv.getParseStr("window_to_pixel");
-
+  else if (argv.hasParseSlot(argSlots.windowToPixel)) {
     QPointF point;
 
-    if (! argToPoint(arg, point))
+    if (! argToPoint(argSlots.windowToPixel, "window_to_pixel", point))
       return false;
 
     double px, py;
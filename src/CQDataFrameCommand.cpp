@@ -6,7 +6,6 @@
 #include <CQDataFrameSVG.h>
 
 #include <CQStrUtil.h>
-#include <CTclParse.h>
 #include <CFile.h>
 #include <COSFile.h>
 
@@ -28,6 +27,8 @@ CommandWidget(Area *area) :
   //---
 
   setFixedFont();
+
+  resetParse();
 }
 
 QString
@@ -46,13 +47,31 @@ draw(QPainter *painter, int dx, int dy)
 
   //---
 
+  // only draw lines in damaged area
+  int y1 = -charData_.height;
+  int y2 = contents_->height() + charData_.height;
+
+  if (painter->hasClipping()) {
+    auto clip = painter->clipBoundingRect().toAlignedRect();
+
+    y1 = clip.top   () - charData_.height;
+    y2 = clip.bottom() + charData_.height;
+  }
+
+  //---
+
   // draw lines (above command line)
   int numLines = int(lines_.size());
 
   for (int i = 0; i < numLines; ++i) {
     auto *line = lines_[size_t(i)];
 
-    drawLine(painter, line, y);
+    if (y > y1 && y <= y2)
+      drawLine(painter, line, y);
+    else {
+      line->setX(0);
+      line->setY(y);
+    }
 
     y += charData_.height;
   }
@@ -62,6 +81,7 @@ draw(QPainter *painter, int dx, int dy)
   // draw prompt on command line
   const auto &prompt = area()->prompt();
 
+  promptX_     = x;
   promptY_     = y;
   promptWidth_ = prompt.length()*charData_.width;
 
@@ -240,38 +260,41 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
 
   //---
 
-  CTclParse parse;
+  // parse is updated by entry edits so only the command containing the
+  // position is tokenized
+  int start = 0, end = 0;
+
+  (void) incrParse_.commandTokens(pos, start, end);
 
-  CTclParse::Tokens tokens;
+  // token positions are relative to command start
+  const auto &index = incrParse_.tokenIndex();
 
-  parse.parseLine(line.toStdString(), tokens);
+  int cpos = pos - start;
 
-  auto *token = parse.getTokenForPos(tokens, pos);
+  auto *token = index.tokenForPos(cpos);
 
   //---
 
   auto *frame = this->frame();
 
-  auto *qtcl = frame->qtcl();
+  auto *mgr = frame->tclCmdMgr();
 
   //---
 
-  auto lhs = line.mid(0, token ? token->pos() : pos + 1);
-  auto str = (token ? token->str() : "");
-  auto rhs = line.mid(token ? token->endPos() + 1 : pos + 1);
+  auto lhs = line.mid(0, token ? start + token->pos() : pos + 1);
+  auto str = (token ? std::string(token->str()) : std::string());
+  auto rhs = line.mid(token ? start + token->endPos() + 1 : pos + 1);
 
   // complete command
   if      (token && token->type() == CTclToken::Type::COMMAND) {
   //std::cerr << "Command: " << str << "\n";
 
-    const auto &cmds = qtcl->commandNames();
-
-    auto matchCmds = CQStrUtil::matchStrs(str.c_str(), cmds);
-
     QString matchStr;
     bool    exact = false;
 
 #if 0
+    auto matchCmds = mgr->matchCommands(str.c_str());
+
     if (interactive && matchCmds.size() > 1) {
       matchStr = showCompletionChooser(matchCmds);
 
@@ -285,7 +308,7 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
     newText = lhs;
 
     if (matchStr == "")
-      newText += CQStrUtil::longestMatch(matchCmds, exact);
+      newText += mgr->completeCommand(str.c_str(), exact);
     else
       newText += matchStr;
 
@@ -301,12 +324,11 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
     // get previous command token for command name
     std::string command;
 
-    for (int pos1 = pos - 1; pos1 >= 0; --pos1) {
-      auto *token1 = parse.getTokenForPos(tokens, pos1);
-      if (! token1) continue;
+    for (int i = index.prevIndex(cpos); i >= 0; --i) {
+      auto *token1 = index.token(i);
 
       if (token1->type() == CTclToken::Type::COMMAND) {
-        command = token1->str();
+        command = std::string(token1->str());
         break;
       }
     }
@@ -323,16 +345,7 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
 
 #if 0
     if (interactive) {
-      auto cmd = QString("complete -command {%1} -option {*} -all").
-                         arg(command.c_str());
-
-      QVariant res;
-
-      (void) qtcl->eval(cmd, res);
-
-      QStringList strs = resultToStrings(res);
-
-      auto matchStrs = CQStrUtil::matchStrs(option.c_str(), strs);
+      auto matchStrs = mgr->matchOptions(command.c_str(), option.c_str());
 
       if (matchStrs.size() > 1) {
         matchStr = showCompletionChooser(matchStrs);
@@ -346,15 +359,18 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
     //---
 
     if (matchStr == "") {
-      // use complete command to complete command option
-      auto cmd = QString("complete -command {%1} -option {%2} -exact_space").
-                         arg(command.c_str()).arg(option.c_str());
+      // complete command option
+      bool exact;
 
-      QVariant res;
+      auto newOption = mgr->completeOption(command.c_str(), option.c_str(), exact);
 
-      (void) qtcl->eval(cmd, res);
+      if (newOption.length() < int(option.length()))
+        return false;
 
-      matchStr = res.toString();
+      matchStr = "-" + newOption;
+
+      if (exact)
+        matchStr += " ";
     }
 
     newText = lhs + matchStr + rhs;
@@ -370,11 +386,10 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
     std::string  option;
     OptionValues optionValues;
 
-    for (int pos1 = pos - 1; pos1 >= 0; --pos1) {
-      auto *token1 = parse.getTokenForPos(tokens, pos1);
-      if (! token1) continue;
+    for (int i = index.prevIndex(cpos); i >= 0; --i) {
+      auto *token1 = index.token(i);
 
-      const auto &str = token1->str();
+      auto str = token1->str();
       if (str.empty()) continue;
 
       if      (token1->type() == CTclToken::Type::COMMAND) {
@@ -386,8 +401,7 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
         if (option.empty())
           option = str.substr(1);
 
-        if (pos1 > token1->pos())
-          pos1 = token1->pos(); // move to start
+        i = index.prevIndex(token1->pos()) + 1; // move to start
       }
     }
 
@@ -397,11 +411,10 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
         // get option values to next command
     std::string lastOption;
 
-    for (int pos1 = commandPos + int(command.length()); pos1 < line.length(); ++pos1) {
-      auto *token1 = parse.getTokenForPos(tokens, pos1);
-      if (! token1) continue;
+    for (int i = index.nextIndex(commandPos + int(command.length())); i < index.size(); ++i) {
+      auto *token1 = index.token(i);
 
-      const auto &str = token1->str();
+      auto str = token1->str();
       if (str.empty()) continue;
 
       if      (token1->type() == CTclToken::Type::COMMAND) {
@@ -412,28 +425,22 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
 
         optionValues[lastOption] = "";
 
-        pos1 = token1->pos() + int(token1->str().length()); // move to end
+        i = index.nextIndex(token1->endPos() + 1) - 1; // move to end
       }
       else {
         if (lastOption != "")
           optionValues[lastOption] = str;
 
-        pos1 = token1->pos() + int(token1->str().length()); // move to end
+        i = index.nextIndex(token1->endPos() + 1) - 1; // move to end
       }
     }
 
     //---
 
-    std::string nameValues;
+    CQTclCmd::Mgr::NameValueMap nameValueMap;
 
-    for (const auto &nv : optionValues) {
-      if (! nameValues.empty())
-        nameValues += " ";
-
-      nameValues += "{{" + nv.first + "} {" + nv.second + "}}";
-    }
-
-    nameValues = "{" + nameValues + "}";
+    for (const auto &nv : optionValues)
+      nameValueMap[nv.first.c_str()] = nv.second.c_str();
 
     //---
 
@@ -442,15 +449,7 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
 
 #if 0
     if (interactive) {
-      auto cmd =
-        QString("complete -command {%1} -option {%2} -value {*} -name_values %3 -all").
-                arg(command.c_str()).arg(option.c_str()).arg(nameValues.c_str());
-
-      QVariant res;
-
-      (void) qtcl->eval(cmd, res);
-
-      QStringList strs = resultToStrings(res);
+      auto strs = mgr->optionValues(command.c_str(), option.c_str(), nameValueMap);
 
       auto matchStrs = CQStrUtil::matchStrs(str.c_str(), strs);
 
@@ -466,16 +465,19 @@ complete(const QString &line, int pos, QString &newText, CompleteMode /*complete
     //---
 
     if (matchStr == "") {
-      // use complete command to complete command option value
-      QVariant res;
+      // complete command option value
+      bool exact;
 
-      auto cmd =
-        QString("complete -command {%1} -option {%2} -value {%3} -name_values %4 -exact_space").
-                arg(command.c_str()).arg(option.c_str()).arg(str.c_str()).arg(nameValues.c_str());
+      auto newValue =
+        mgr->completeValue(command.c_str(), option.c_str(), str.c_str(), nameValueMap, exact);
 
-      qtcl->eval(cmd, res);
+      if (newValue.length() < int(str.length()))
+        return false;
 
-      matchStr = res.toString();
+      matchStr = newValue;
+
+      if (exact)
+        matchStr += " ";
     }
 
     newText = lhs + matchStr + rhs;
@@ -491,6 +493,10 @@ CommandWidget::
 mousePressEvent(QMouseEvent *e)
 {
   if      (e->button() == Qt::LeftButton) {
+    // repaint lines of previous selection
+    if (hasSelection())
+      updateLineRange(mouseData_.pressLineNum, mouseData_.moveLineNum);
+
     (void) pixelToText(e->pos(), mouseData_.pressLineNum, mouseData_.pressCharNum);
 
     mouseData_.pressed     = true;
@@ -498,9 +504,12 @@ mousePressEvent(QMouseEvent *e)
     mouseData_.moveCharNum = mouseData_.pressCharNum;
   }
   else if (e->button() == Qt::MiddleButton) {
+    auto oldText = entry_.getText();
+    int  oldPos  = entry_.getPos();
+
     paste();
 
-    update();
+    updateEntry(oldText, oldPos);
   }
 }
 
@@ -509,9 +518,16 @@ CommandWidget::
 mouseMoveEvent(QMouseEvent *e)
 {
   if (mouseData_.pressed) {
+    int lineNum = mouseData_.moveLineNum;
+    int charNum = mouseData_.moveCharNum;
+
     (void) pixelToText(e->pos(), mouseData_.moveLineNum, mouseData_.moveCharNum);
 
-    update();
+    if (lineNum == mouseData_.moveLineNum && charNum == mouseData_.moveCharNum)
+      return;
+
+    // selection only changes on lines between old and new end
+    updateLineRange(lineNum, mouseData_.moveLineNum);
   }
 }
 
@@ -550,6 +566,61 @@ pixelToText(const QPoint &p, int &lineNum, int &charNum)
   return false;
 }
 
+QRect
+CommandWidget::
+lineRect(int lineNum) const
+{
+  // current line
+  if (lineNum == int(lines_.size()))
+    return QRect(0, promptY_, contents_->width(), charData_.height);
+
+  return Widget::lineRect(lineNum);
+}
+
+bool
+CommandWidget::
+hasSelection() const
+{
+  return (mouseData_.pressLineNum != mouseData_.moveLineNum ||
+          mouseData_.pressCharNum != mouseData_.moveCharNum);
+}
+
+void
+CommandWidget::
+updateEntry(const QString &oldText, int oldPos)
+{
+  // selection drawn over entry text so update all lines it covers
+  if (hasSelection()) {
+    contentsUpdateSlot();
+    return;
+  }
+
+  const auto &text = entry_.getText();
+  int         pos  = entry_.getPos();
+
+  int len1 = oldText.length();
+  int len2 = text   .length();
+
+  // first changed character
+  int i1 = 0;
+
+  while (i1 < len1 && i1 < len2 && oldText[i1] == text[i1])
+    ++i1;
+
+  i1 = std::min(i1, std::min(oldPos, pos));
+
+  // last changed character (text after edit is shifted, cursor cell may be past end)
+  int i2 = std::max(oldPos, pos);
+
+  if (oldText != text)
+    i2 = std::max(i2, std::max(len1, len2));
+
+  int x = promptX_ + promptWidth_ + i1*charData_.width;
+  int w = (i2 - i1 + 1)*charData_.width;
+
+  contents_->update(QRect(x, promptY_, w, charData_.height));
+}
+
 bool
 CommandWidget::
 event(QEvent *e)
@@ -566,11 +637,14 @@ event(QEvent *e)
       QString text;
 
       if (complete(getText(), entry_.getPos(), text, completeMode)) {
+        auto oldText = entry_.getText();
+        int  oldPos  = entry_.getPos();
+
         entry_.setText(text);
 
         entry_.cursorEnd();
 
-        update();
+        updateEntry(oldText, oldPos);
       }
 
       return true;
@@ -587,6 +661,11 @@ keyPressEvent(QKeyEvent *event)
   auto key = event->key();
   auto mod = event->modifiers();
 
+  // save entry state to calculate damaged area
+  auto oldText     = entry_.getText();
+  int  oldPos      = entry_.getPos();
+  auto oldNumLines = lines_.size();
+
   // run command
   if (key == Qt::Key_Return || key == Qt::Key_Enter) {
     auto line = getText().trimmed();
@@ -663,6 +742,9 @@ keyPressEvent(QKeyEvent *event)
       placeWidgets();
     }
 
+    // lines changed
+    resetParse();
+
     setFocus();
   }
   else if (key == Qt::Key_Left) {
@@ -746,7 +828,11 @@ keyPressEvent(QKeyEvent *event)
     entry_.insert(event->text());
   }
 
-  update();
+  // repaint all if lines changed, otherwise only changed part of entry line
+  if (key == Qt::Key_Return || key == Qt::Key_Enter || lines_.size() != oldNumLines)
+    scheduleUpdate();
+  else
+    updateEntry(oldText, oldPos);
 }
 
 bool
@@ -755,14 +841,23 @@ isCompleteLine(const QString &line, bool &isTcl) const
 {
   if (line == "") return false;
 
-  // parse command
-  std::string              name;
-  std::vector<std::string> args;
+  // get command name (first word)
+  int len = line.length();
 
-  parseCommand(line, name, args);
+  int i1 = 0;
+
+  while (i1 < len && line[i1].isSpace())
+    ++i1;
+
+  int i2 = i1;
+
+  while (i2 < len && ! line[i2].isSpace())
+    ++i2;
+
+  auto name = line.mid(i1, i2 - i1);
 
   // TODO: command map
-  if (name == "cd" || name[0] == '!') {
+  if (name == "cd" || name.startsWith('!')) {
     isTcl = false;
 
     if (line[line.length() - 1] == '\\')
@@ -773,7 +868,8 @@ isCompleteLine(const QString &line, bool &isTcl) const
   else {
     isTcl = true;
 
-    return CTclUtil::isCompleteLine(line.toStdString());
+    // parse is updated by entry edits (surrounding space does not change result)
+    return incrParse_.isComplete();
   }
 }
 
@@ -1014,6 +1110,20 @@ clearText()
   clearEntry();
 
   lines_.clear();
+
+  resetParse();
+}
+
+void
+CommandWidget::
+resetParse()
+{
+  // set whole text when lines change (entry edits update parse incrementally)
+  auto text = getText();
+
+  incrParse_.setText(text.toLatin1().toStdString());
+
+  entry_.setParse(&incrParse_, text.length() - entry_.getText().length());
 }
 
 QSize
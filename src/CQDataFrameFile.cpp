@@ -117,8 +117,6 @@ bool
 FileTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -137,8 +137,6 @@ bool
 FileMgrTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -120,8 +120,6 @@ bool
 HtmlTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -1,6 +1,7 @@
 #include <CQDataFrameImage.h>
 
 #include <QPainter>
+#include <QDataStream>
 #include <QMenu>
 
 namespace CQDataFrame {
@@ -84,6 +85,8 @@ void
 ImageWidget::
 updateImage()
 {
+  invalidateCache();
+
   if (image_.isNull())
     return;
 
@@ -99,7 +102,42 @@ updateImage()
   else
     simage_ = QImage();
 
-  update();
+  scheduleUpdate();
+}
+
+qint64
+ImageWidget::
+payloadBytes() const
+{
+  return image_.sizeInBytes() + simage_.sizeInBytes();
+}
+
+bool
+ImageWidget::
+writePayload(QDataStream &os) const
+{
+  os << image_;
+
+  return (os.status() == QDataStream::Ok);
+}
+
+void
+ImageWidget::
+freePayload()
+{
+  image_  = QImage();
+  simage_ = QImage();
+}
+
+bool
+ImageWidget::
+readPayload(QDataStream &is)
+{
+  is >> image_;
+
+  updateImage();
+
+  return (is.status() == QDataStream::Ok);
 }
 
 bool
@@ -258,8 +296,6 @@ bool
 ImageTclCmd::
 exec(CQTclCmd::CmdArgs &argv)
 {
-  addArgs(argv);
-
   bool rc;
 
   if (! argv.parse(rc))
@@ -0,0 +1,374 @@
+#include <CQDataFrameMemoryMgr.h>
+#include <CQDataFrame.h>
+#include <CQDataFrameWidget.h>
+
+#include <QTemporaryFile>
+#include <QDir>
+#include <QDataStream>
+#include <QTimer>
+#include <algorithm>
+
+namespace CQDataFrame {
+
+MemoryMgr::
+MemoryMgr(Frame *frame) :
+ QObject(frame), frame_(frame)
+{
+  setObjectName("memoryMgr");
+
+  // budget checks are batched (widgets added or changed in bursts)
+  timer_ = new QTimer(this);
+
+  timer_->setSingleShot(true);
+  timer_->setInterval(500);
+
+  connect(timer_, SIGNAL(timeout()), this, SLOT(timerSlot()));
+}
+
+MemoryMgr::
+~MemoryMgr()
+{
+  delete file_;
+}
+
+void
+MemoryMgr::
+setMaxBytes(qint64 n)
+{
+  maxBytes_ = n;
+
+  scheduleCheck();
+}
+
+qint64
+MemoryMgr::
+usedBytes() const
+{
+  qint64 bytes = 0;
+
+  for (const auto &pd : widgetDatas_) {
+    const auto &data = pd.second;
+
+    if (data.widget && ! data.spilled)
+      bytes += data.widget->payloadBytes();
+  }
+
+  return bytes;
+}
+
+void
+MemoryMgr::
+addWidget(Widget *widget)
+{
+  auto &data = widgetDatas_[widget];
+
+  data = WidgetData();
+
+  data.widget     = widget;
+  data.lastViewed = ++viewCount_;
+
+  scheduleCheck();
+}
+
+void
+MemoryMgr::
+removeWidget(Widget *widget)
+{
+  auto p = widgetDatas_.find(widget);
+  if (p == widgetDatas_.end()) return;
+
+  (void) restore(widget);
+
+  widgetDatas_.erase(p);
+}
+
+void
+MemoryMgr::
+touch(Widget *widget)
+{
+  auto p = widgetDatas_.find(widget);
+  if (p == widgetDatas_.end()) return;
+
+  (*p).second.lastViewed = ++viewCount_;
+
+  if ((*p).second.spilled)
+    (void) restore(widget);
+}
+
+bool
+MemoryMgr::
+restore(Widget *widget)
+{
+  auto p = widgetDatas_.find(widget);
+  if (p == widgetDatas_.end()) return false;
+
+  auto &data = (*p).second;
+
+  if (! data.spilled)
+    return false;
+
+  //---
+
+  // widget stays spilled (retried on next touch) if read or restore fails
+  if (! file_ || ! file_->seek(data.offset)) {
+    std::cerr << "Failed to read spill file for '" << widget->id().toStdString() << "'\n";
+    return false;
+  }
+
+  auto bytes = file_->read(data.size);
+
+  if (bytes.size() != data.size) {
+    std::cerr << "Failed to read spill file for '" << widget->id().toStdString() << "'\n";
+    return false;
+  }
+
+  QDataStream is(bytes);
+
+  if (! widget->restorePayload(is)) {
+    std::cerr << "Failed to restore '" << widget->id().toStdString() << "'\n";
+    return false;
+  }
+
+  data.spilled = false;
+
+  ++numRestores_;
+
+  freeRange(data.offset, data.size);
+
+  // reclaim spill file space when nothing left spilled
+  if (numSpilled() == 0) {
+    file_->resize(0);
+
+    freeRanges_.clear();
+  }
+
+  // restored payload may put session over budget
+  scheduleCheck();
+
+  return true;
+}
+
+void
+MemoryMgr::
+scheduleCheck()
+{
+  if (! timer_->isActive())
+    timer_->start();
+}
+
+void
+MemoryMgr::
+timerSlot()
+{
+  checkBudget();
+}
+
+void
+MemoryMgr::
+checkBudget()
+{
+  // remove deleted widgets (spill file space of spilled ones is reused)
+  for (auto p = widgetDatas_.begin(); p != widgetDatas_.end(); ) {
+    if (! (*p).second.widget) {
+      if ((*p).second.spilled)
+        freeRange((*p).second.offset, (*p).second.size);
+
+      p = widgetDatas_.erase(p);
+    }
+    else
+      ++p;
+  }
+
+  //---
+
+  qint64 bytes = usedBytes();
+
+  if (bytes <= maxBytes_)
+    return;
+
+  // get in memory widgets which are not visible, least recently viewed first
+  using WidgetDataP = WidgetData *;
+
+  std::vector<WidgetDataP> candidates;
+
+  for (auto &pd : widgetDatas_) {
+    auto &data = pd.second;
+
+    if (data.spilled || data.widget->payloadBytes() <= 0)
+      continue;
+
+    if (! data.widget->visibleRegion().isEmpty())
+      continue;
+
+    candidates.push_back(&data);
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+    [](const WidgetDataP &lhs, const WidgetDataP &rhs) {
+      return lhs->lastViewed < rhs->lastViewed;
+    });
+
+  //---
+
+  for (auto *data : candidates) {
+    if (bytes <= maxBytes_)
+      break;
+
+    qint64 payloadBytes = data->widget->payloadBytes();
+
+    if (spill(data->widget))
+      bytes -= payloadBytes;
+  }
+}
+
+int
+MemoryMgr::
+numSpilled() const
+{
+  int n = 0;
+
+  for (const auto &pd : widgetDatas_)
+    if (pd.second.spilled)
+      ++n;
+
+  return n;
+}
+
+bool
+MemoryMgr::
+spill(Widget *widget)
+{
+  auto p = widgetDatas_.find(widget);
+  if (p == widgetDatas_.end()) return false;
+
+  auto &data = (*p).second;
+
+  if (data.spilled)
+    return false;
+
+  if (! openFile())
+    return false;
+
+  //---
+
+  // serialize payload (payload only released once safely written)
+  QByteArray bytes;
+
+  QDataStream os(&bytes, QIODevice::WriteOnly);
+
+  if (! widget->writePayload(os))
+    return false;
+
+  qint64 offset = allocRange(bytes.size());
+
+  if (! file_->seek(offset) || file_->write(bytes) != bytes.size()) {
+    std::cerr << "Failed to write spill file for '" << widget->id().toStdString() << "'\n";
+
+    freeRange(offset, bytes.size());
+
+    return false;
+  }
+
+  widget->releasePayload();
+
+  data.spilled = true;
+  data.offset  = offset;
+  data.size    = bytes.size();
+
+  ++numSpills_;
+
+  return true;
+}
+
+qint64
+MemoryMgr::
+allocRange(qint64 size)
+{
+  // first free range large enough (rest of range stays free)
+  for (auto p = freeRanges_.begin(); p != freeRanges_.end(); ++p) {
+    if ((*p).size < size)
+      continue;
+
+    qint64 offset = (*p).offset;
+
+    (*p).offset += size;
+    (*p).size   -= size;
+
+    if ((*p).size == 0)
+      freeRanges_.erase(p);
+
+    return offset;
+  }
+
+  return file_->size();
+}
+
+void
+MemoryMgr::
+freeRange(qint64 offset, qint64 size)
+{
+  if (size <= 0)
+    return;
+
+  Range range;
+
+  range.offset = offset;
+  range.size   = size;
+
+  auto p = std::lower_bound(freeRanges_.begin(), freeRanges_.end(), range,
+    [](const Range &lhs, const Range &rhs) { return lhs.offset < rhs.offset; });
+
+  p = freeRanges_.insert(p, range);
+
+  // merge with next and previous
+  auto pn = p + 1;
+
+  if (pn != freeRanges_.end() && (*p).offset + (*p).size == (*pn).offset) {
+    (*p).size += (*pn).size;
+
+    freeRanges_.erase(pn);
+  }
+
+  if (p != freeRanges_.begin()) {
+    auto pp = p - 1;
+
+    if ((*pp).offset + (*pp).size == (*p).offset) {
+      (*pp).size += (*p).size;
+
+      p = freeRanges_.erase(p) - 1;
+    }
+  }
+
+  // truncate free range at end of file
+  if (file_ && (*p).offset + (*p).size >= file_->size()) {
+    file_->resize((*p).offset);
+
+    freeRanges_.erase(p);
+  }
+}
+
+bool
+MemoryMgr::
+openFile()
+{
+  if (file_)
+    return true;
+
+  file_ = new QTemporaryFile;
+
+  file_->setFileTemplate(QDir::tempPath() + "/CQDataFrame.XXXXXX.spill");
+
+  if (! file_->open()) {
+    std::cerr << "Failed to open spill file\n";
+
+    delete file_;
+
+    file_ = nullptr;
+
+    return false;
+  }
+
+  return true;
+}
+
+}
@@ -0,0 +1,114 @@
+#include <CQDataFrameRasterCache.h>
+#include <CQDataFrameWidget.h>
+
+namespace CQDataFrame {
+
+RasterCache *
+RasterCache::
+instance()
+{
+  static RasterCache cache;
+
+  return &cache;
+}
+
+void
+RasterCache::
+setEnabled(bool b)
+{
+  enabled_ = b;
+
+  if (! enabled_)
+    clear();
+}
+
+void
+RasterCache::
+setMaxBytes(qint64 n)
+{
+  maxBytes_ = n;
+
+  evict();
+}
+
+void
+RasterCache::
+add(WidgetContents *contents, qint64 bytes)
+{
+  for (auto p = entries_.begin(); p != entries_.end(); ++p) {
+    if ((*p).contents == contents) {
+      usedBytes_ -= (*p).bytes;
+
+      entries_.erase(p);
+
+      break;
+    }
+  }
+
+  entries_.emplace_front(contents, bytes);
+
+  usedBytes_ += bytes;
+
+  evict();
+}
+
+void
+RasterCache::
+touch(WidgetContents *contents)
+{
+  for (auto p = entries_.begin(); p != entries_.end(); ++p) {
+    if ((*p).contents == contents) {
+      if (p != entries_.begin())
+        entries_.splice(entries_.begin(), entries_, p);
+
+      return;
+    }
+  }
+}
+
+void
+RasterCache::
+remove(WidgetContents *contents)
+{
+  for (auto p = entries_.begin(); p != entries_.end(); ++p) {
+    if ((*p).contents == contents) {
+      usedBytes_ -= (*p).bytes;
+
+      entries_.erase(p);
+
+      return;
+    }
+  }
+}
+
+void
+RasterCache::
+clear()
+{
+  Entries entries;
+
+  std::swap(entries, entries_);
+
+  usedBytes_ = 0;
+
+  for (auto &entry : entries)
+    entry.contents->releaseCache();
+}
+
+void
+RasterCache::
+evict()
+{
+  // release least recently used (keep most recent even if over budget)
+  while (usedBytes_ > maxBytes_ && entries_.size() > 1) {
+    auto entry = entries_.back();
+
+    entries_.pop_back();
+
+    usedBytes_ -= entry.bytes;
+
+    entry.contents->releaseCache();
+  }
+}
+
+}
@@ -0,0 +1,368 @@
+#include <CQDataFrameReactiveMgr.h>
+#include <CQDataFrame.h>
+#include <CQDataFrameTcl.h>
+
+#include <QTimer>
+#include <algorithm>
+
+namespace CQDataFrame {
+
+ReactiveMgr::
+ReactiveMgr(Frame *frame) :
+ QObject(frame), frame_(frame)
+{
+  setObjectName("reactiveMgr");
+
+  // reruns are debounced (variables often written in bursts)
+  timer_ = new QTimer(this);
+
+  timer_->setSingleShot(true);
+  timer_->setInterval(100);
+
+  connect(timer_, SIGNAL(timeout()), this, SLOT(timerSlot()));
+
+  connect(frame_->qtcl(), SIGNAL(varRead(const QString &)),
+          this, SLOT(varReadSlot(const QString &)));
+  connect(frame_->qtcl(), SIGNAL(varWritten(const QString &)),
+          this, SLOT(varWrittenSlot(const QString &)));
+}
+
+int
+ReactiveMgr::
+delay() const
+{
+  return timer_->interval();
+}
+
+void
+ReactiveMgr::
+setDelay(int ms)
+{
+  timer_->setInterval(std::max(ms, 0));
+}
+
+void
+ReactiveMgr::
+addWidget(TclWidget *widget)
+{
+  auto &data = widgetDatas_[widget];
+
+  data.widget = widget;
+}
+
+void
+ReactiveMgr::
+removeWidget(TclWidget *widget)
+{
+  widgetDatas_.erase(widget);
+
+  dirty_.erase(widget);
+
+  // drop traces if last reactive widget
+  if (widgetDatas_.empty())
+    untraceGlobals();
+}
+
+void
+ReactiveMgr::
+startRun(TclWidget *widget)
+{
+  auto p = widgetDatas_.find(widget);
+  if (p == widgetDatas_.end()) return;
+
+  (*p).second.reads .clear();
+  (*p).second.writes.clear();
+
+  // reads are only reported for traced variables
+  traceGlobals();
+
+  running_.push_back(widget);
+}
+
+void
+ReactiveMgr::
+endRun(TclWidget *widget)
+{
+  if (running_.empty() || running_.back() != widget)
+    return;
+
+  running_.pop_back();
+
+  // trace globals created by run
+  traceGlobals();
+}
+
+QStringList
+ReactiveMgr::
+readVars(TclWidget *widget) const
+{
+  QStringList names;
+
+  auto p = widgetDatas_.find(widget);
+
+  if (p != widgetDatas_.end()) {
+    for (const auto &name : (*p).second.reads)
+      names << name;
+  }
+
+  return names;
+}
+
+QStringList
+ReactiveMgr::
+writeVars(TclWidget *widget) const
+{
+  QStringList names;
+
+  auto p = widgetDatas_.find(widget);
+
+  if (p != widgetDatas_.end()) {
+    for (const auto &name : (*p).second.writes)
+      names << name;
+  }
+
+  return names;
+}
+
+void
+ReactiveMgr::
+traceGlobals()
+{
+  auto *qtcl   = frame_->qtcl();
+  auto *interp = qtcl->interp();
+
+  // keep interpreter result and error state (may still be read by caller)
+  auto *state = Tcl_SaveInterpState(interp, TCL_OK);
+
+  QStringList names;
+
+  if (Tcl_EvalEx(interp, "info globals", -1, TCL_EVAL_GLOBAL) == TCL_OK)
+    (void) CQTclUtil::splitList(CQTclUtil::stringFromObj(Tcl_GetObjResult(interp)), names);
+
+  (void) Tcl_RestoreInterpState(interp, state);
+
+  for (const auto &name : names) {
+    // skip interpreter state variables
+    if (name.startsWith("tcl_") || name.startsWith("auto_") || name == "env" ||
+        name == "errorInfo" || name == "errorCode")
+      continue;
+
+    // no-op if already traced
+    qtcl->traceVar(name);
+
+    traced_.insert(name);
+  }
+}
+
+void
+ReactiveMgr::
+untraceGlobals()
+{
+  auto *qtcl = frame_->qtcl();
+
+  for (const auto &name : traced_)
+    qtcl->untraceVar(name);
+
+  traced_.clear();
+}
+
+void
+ReactiveMgr::
+varReadSlot(const QString &name)
+{
+  if (running_.empty())
+    return;
+
+  auto p = widgetDatas_.find(running_.back());
+  if (p == widgetDatas_.end()) return;
+
+  // value produced by same cell is not a dependency
+  auto &data = (*p).second;
+
+  if (data.writes.find(name) == data.writes.end())
+    data.reads.insert(name);
+}
+
+void
+ReactiveMgr::
+varWrittenSlot(const QString &name)
+{
+  TclWidget *current = nullptr;
+
+  if (! running_.empty()) {
+    current = running_.back();
+
+    auto p = widgetDatas_.find(current);
+
+    if (p != widgetDatas_.end())
+      (*p).second.writes.insert(name);
+  }
+
+  //---
+
+  // mark dependent widgets dirty (widgets in running batch are already ordered)
+  bool changed = false;
+
+  for (const auto &pd : widgetDatas_) {
+    auto *widget = pd.first;
+
+    if (widget == current || batch_.find(widget) != batch_.end())
+      continue;
+
+    if (pd.second.reads.find(name) == pd.second.reads.end())
+      continue;
+
+    dirty_.insert(widget);
+
+    changed = true;
+  }
+
+  // restart debounce timer
+  if (changed)
+    timer_->start();
+}
+
+void
+ReactiveMgr::
+timerSlot()
+{
+  // remove deleted widgets
+  for (auto p = widgetDatas_.begin(); p != widgetDatas_.end(); ) {
+    if (! (*p).second.widget) {
+      dirty_.erase((*p).first);
+
+      p = widgetDatas_.erase(p);
+    }
+    else
+      ++p;
+  }
+
+  if (widgetDatas_.empty())
+    untraceGlobals();
+
+  if (dirty_.empty())
+    return;
+
+  //---
+
+  // add widgets downstream of dirty widgets (rerun once, after their inputs)
+  WidgetSet batch = dirty_;
+
+  dirty_.clear();
+
+  Widgets pending(batch.begin(), batch.end());
+
+  while (! pending.empty()) {
+    auto *widget = pending.back(); pending.pop_back();
+
+    const auto &writes = widgetDatas_[widget].writes;
+
+    for (const auto &pd : widgetDatas_) {
+      if (batch.find(pd.first) != batch.end())
+        continue;
+
+      for (const auto &name : writes) {
+        if (pd.second.reads.find(name) != pd.second.reads.end()) {
+          batch.insert(pd.first);
+
+          pending.push_back(pd.first);
+
+          break;
+        }
+      }
+    }
+  }
+
+  Widgets sorted;
+
+  sortWidgets(batch, sorted);
+
+  //---
+
+  batch_ = batch;
+
+  for (auto *widget : sorted) {
+    auto p = widgetDatas_.find(widget);
+
+    if (p == widgetDatas_.end() || ! (*p).second.widget)
+      continue;
+
+    ++numReruns_;
+
+    widget->rerun();
+  }
+
+  batch_.clear();
+}
+
+void
+ReactiveMgr::
+sortWidgets(const WidgetSet &widgets, Widgets &sorted) const
+{
+  // Kahn topological sort (edge from writer to reader of a variable)
+  auto isEdge = [&](TclWidget *from, TclWidget *to) {
+    const auto &writes = widgetDatas_.at(from).writes;
+    const auto &reads  = widgetDatas_.at(to  ).reads;
+
+    for (const auto &name : writes)
+      if (reads.find(name) != reads.end())
+        return true;
+
+    return false;
+  };
+
+  // ready widgets processed in cell order
+  auto widgetLess = [](TclWidget *lhs, TclWidget *rhs) { return lhs->pos() < rhs->pos(); };
+
+  Widgets widgets1(widgets.begin(), widgets.end());
+
+  std::sort(widgets1.begin(), widgets1.end(), widgetLess);
+
+  std::map<TclWidget *, int> inDegree;
+
+  for (auto *to : widgets1) {
+    int n = 0;
+
+    for (auto *from : widgets1)
+      if (from != to && isEdge(from, to))
+        ++n;
+
+    inDegree[to] = n;
+  }
+
+  Widgets ready;
+
+  for (auto *widget : widgets1)
+    if (inDegree[widget] == 0)
+      ready.push_back(widget);
+
+  WidgetSet done;
+
+  while (! ready.empty()) {
+    auto *widget = ready.front();
+
+    ready.erase(ready.begin());
+
+    sorted.push_back(widget);
+
+    done.insert(widget);
+
+    for (auto *to : widgets1) {
+      if (to == widget || done.find(to) != done.end() || ! isEdge(widget, to))
+        continue;
+
+      if (--inDegree[to] == 0) {
+        ready.push_back(to);
+
+        std::sort(ready.begin(), ready.end(), widgetLess);
+      }
+    }
+  }
+
+  // widgets in cycles run in cell order
+  for (auto *widget : widgets1)
+    if (done.find(widget) == done.end())
+      sorted.push_back(widget);
+}
+
+}
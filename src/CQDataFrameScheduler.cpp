@@ -0,0 +1,120 @@
+#include <CQDataFrameScheduler.h>
+#include <CQDataFrame.h>
+
+#include <QTimer>
+
+namespace CQDataFrame {
+
+Scheduler::
+Scheduler(Frame *frame) :
+ QObject(frame), frame_(frame)
+{
+  setObjectName("scheduler");
+
+  // zero interval single shot timer fires on next event loop turn
+  timer_ = new QTimer(this);
+
+  timer_->setSingleShot(true);
+  timer_->setInterval(0);
+
+  connect(timer_, SIGNAL(timeout()), this, SLOT(timerSlot()));
+}
+
+void
+Scheduler::
+requestLayout(Area *area)
+{
+  if (isLayoutPending(area)) {
+    ++numSkipped_;
+    return;
+  }
+
+  areas_.push_back(area);
+
+  startTimer();
+}
+
+void
+Scheduler::
+requestUpdate(QWidget *widget)
+{
+  for (const auto &widget1 : widgets_) {
+    if (widget1 == widget) {
+      ++numUpdatesSkipped_;
+      return;
+    }
+  }
+
+  widgets_.push_back(widget);
+
+  startTimer();
+}
+
+void
+Scheduler::
+startLayout(Area *area)
+{
+  ++numLayouts_;
+
+  Areas areas;
+
+  for (const auto &area1 : areas_)
+    if (area1 != area)
+      areas.push_back(area1);
+
+  std::swap(areas_, areas);
+}
+
+void
+Scheduler::
+flushLayout(Area *area)
+{
+  if (isLayoutPending(area))
+    area->placeWidgets();
+}
+
+bool
+Scheduler::
+isLayoutPending(Area *area) const
+{
+  for (const auto &area1 : areas_)
+    if (area1 == area)
+      return true;
+
+  return false;
+}
+
+void
+Scheduler::
+startTimer()
+{
+  if (! timer_->isActive())
+    timer_->start();
+}
+
+void
+Scheduler::
+timerSlot()
+{
+  // place widgets (areas remove themselves from pending list when placed)
+  while (! areas_.empty()) {
+    auto *area = areas_.front();
+
+    area->placeWidgets();
+  }
+
+  // repaint after layout so paint sees final geometry
+  Widgets widgets;
+
+  std::swap(widgets, widgets_);
+
+  for (const auto &widget : widgets) {
+    if (widget) {
+      widget->update();
+
+      ++numUpdates_;
+    }
+  }
+}
+
+}
@@ -1,5 +1,6 @@
 #include <CQDataFrameTcl.h>
 #include <CQDataFrame.h>
+#include <CQDataFrameReactiveMgr.h>
 #include <CQIconButton.h>
 
 #include <QTextEdit>
@@ -90,8 +91,17 @@ setCmd(const QString &s)
 
   auto cmd1 = (expr_ ? "expr {" + cmd_ + "}" : cmd_);
 
+  // record global variables used by reactive command
+  auto *reactiveMgr = (reactive_ ? frame()->reactiveMgr() : nullptr);
+
+  if (reactiveMgr)
+    reactiveMgr->startRun(this);
+
   bool rc = runTclCommand(cmd1, res);
 
+  if (reactiveMgr)
+    reactiveMgr->endRun(this);
+
   setText(res);
 
   setIsError(! rc);
@@ -102,6 +112,66 @@ setCmd(const QString &s)
   emit contentsChanged();
 }
 
+void
+TclWidget::
+setReactive(bool b)
+{
+  if (b == reactive_)
+    return;
+
+  reactive_ = b;
+
+  // rerun to record dependencies
+  if (reactive_) {
+    frame()->reactiveMgr()->addWidget(this);
+
+    rerun();
+  }
+  else
+    frame()->reactiveMgr()->removeWidget(this);
+}
+
+void
+TclWidget::
+rerun()
+{
+  setCmd(cmd_);
+}
+
+bool
+TclWidget::
+getNameValue(const QString &name, QVariant &value) const
+{
+  if      (name == "reactive")
+    value = isReactive();
+  else if (name == "reads" && reactive_)
+    value = frame()->reactiveMgr()->readVars(const_cast<TclWidget *>(this));
+  else if (name == "writes" && reactive_)
+    value = frame()->reactiveMgr()->writeVars(const_cast<TclWidget *>(this));
+  else
+    return TextWidget::getNameValue(name, value);
+
+  return true;
+}
+
+bool
+TclWidget::
+setNameValue(const QString &name, const QVariant &value)
+{
+  if (name == "reactive") {
+    bool ok;
+
+    bool b = Frame::s_stringToBool(value.toString(), &ok);
+    if (! ok) return false;
+
+    setReactive(b);
+  }
+  else
+    return TextWidget::setNameValue(name, value);
+
+  return true;
+}
+
 void
 TclWidget::
 addMenuItems(QMenu *menu)
@@ -111,6 +181,13 @@ addMenuItems(QMenu *menu)
   auto *rerunAction = menu->addAction("Rerun");
 
   connect(rerunAction, SIGNAL(triggered()), this, SLOT(rerunSlot()));
+
+  auto *reactiveAction = menu->addAction("Reactive");
+
+  reactiveAction->setCheckable(true);
+  reactiveAction->setChecked  (isReactive());
+
+  connect(reactiveAction, SIGNAL(triggered(bool)), this, SLOT(reactiveSlot(bool)));
 }
 
 void
@@ -138,15 +215,23 @@ void
 TclWidget::
 rerunSlot()
 {
-  setCmd(cmd_);
+  rerun();
+}
+
+void
+TclWidget::
+reactiveSlot(bool b)
+{
+  setReactive(b);
 }
 
 void
 TclWidget::
-draw(QPainter *painter, int dx, int dy)
+resizeEvent(QResizeEvent *e)
 {
-  TextWidget::draw(painter, dx, dy);
+  TextWidget::resizeEvent(e);
 
+  // edit widgets are placed relative to widget size
   updateLayout();
 }
 
@@ -1,6 +1,7 @@
 #include <CQDataFrameText.h>
 
 #include <QPainter>
+#include <QDataStream>
 
 namespace CQDataFrame {
 
@@ -39,6 +40,50 @@ setText(const QString &text)
   text_ = text;
 
   updateLines();
+
+  invalidateCache();
+}
+
+qint64
+TextWidget::
+payloadBytes() const
+{
+  // text and lines copy
+  qint64 n = text_.size();
+
+  for (const auto &line : lines_)
+    n += line->text().size();
+
+  return n*qint64(sizeof(QChar));
+}
+
+bool
+TextWidget::
+writePayload(QDataStream &os) const
+{
+  os << text_;
+
+  return (os.status() == QDataStream::Ok);
+}
+
+void
+TextWidget::
+freePayload()
+{
+  text_ = QString();
+
+  freeLines(lines_);
+}
+
+bool
+TextWidget::
+readPayload(QDataStream &is)
+{
+  is >> text_;
+
+  updateLines();
+
+  return (is.status() == QDataStream::Ok);
 }
 
 void
@@ -103,8 +148,16 @@ void
 TextWidget::
 drawText(QPainter *painter, int x, int &y)
 {
-//int w = this->width ();
-  int h = this->height();
+  // only draw lines in damaged area
+  int y1 = -charData_.height;
+  int y2 = this->height() + charData_.height;
+
+  if (painter->hasClipping()) {
+    auto clip = painter->clipBoundingRect().toAlignedRect();
+
+    y1 = clip.top   () - charData_.height;
+    y2 = clip.bottom() + charData_.height;
+  }
 
   // draw lines
   painter->setPen(fgColor_);
@@ -113,7 +166,7 @@ drawText(QPainter *painter, int x, int &y)
     line->setX(x);
     line->setY(y);
 
-    bool onScreen = (y > -charData_.height && y <= h + charData_.height);
+    bool onScreen = (y > y1 && y <= y2);
 
     if (onScreen)
       Widget::drawText(painter, x, y, line->text());
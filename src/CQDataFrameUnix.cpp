@@ -153,7 +153,7 @@ textChangedSlot()
     args_.clear();
   }
 
-  update();
+  scheduleUpdate();
 }
 
 void
@@ -170,6 +170,16 @@ rerunSlot()
   setCmd(cmdStr());
 }
 
+void
+UnixWidget::
+resizeEvent(QResizeEvent *e)
+{
+  TextWidget::resizeEvent(e);
+
+  // edit widgets are placed relative to widget size
+  updateLayout();
+}
+
 void
 UnixWidget::
 draw(QPainter *painter, int dx, int dy)
@@ -184,8 +194,6 @@ draw(QPainter *painter, int dx, int dy)
 
     Widget::drawText(painter, dx, dy, errMsg_);
   }
-
-  updateLayout();
 }
 
 QSize
@@ -1,6 +1,9 @@
 #include <CQDataFrameWidget.h>
 #include <CQDataFrame.h>
 #include <CQDataFrameEscapeParse.h>
+#include <CQDataFrameRasterCache.h>
+#include <CQDataFrameMemoryMgr.h>
+#include <CQDataFrameScheduler.h>
 
 #include <CQUtil.h>
 #include <CQStrParse.h>
@@ -12,6 +15,7 @@
 #include <QMenu>
 #include <QContextMenuEvent>
 #include <QMouseEvent>
+#include <QPaintEvent>
 #include <QClipboard>
 #include <QPainter>
 #include <QHBoxLayout>
@@ -43,6 +47,8 @@ Widget(Area *area) :
 
   connect(scrollArea_, SIGNAL(updateArea()), this, SLOT(contentsUpdateSlot()));
 
+  connect(this, SIGNAL(contentsChanged()), this, SLOT(contentsChangedSlot()));
+
   layout->addWidget(scrollArea_);
 
   bgColor_ = QColor(220, 220, 220);
@@ -61,7 +67,24 @@ void
 Widget::
 contentsUpdateSlot()
 {
-  contents_->update();
+  frame()->scheduler()->requestUpdate(contents_);
+}
+
+void
+Widget::
+scheduleUpdate()
+{
+  frame()->scheduler()->requestUpdate(this);
+}
+
+void
+Widget::
+contentsChangedSlot()
+{
+  invalidateCache();
+
+  // changed payload may put session over budget
+  frame()->memoryMgr()->scheduleCheck();
 }
 
 void
@@ -71,6 +94,8 @@ setExpanded(bool b)
   if (b != expanded_) {
     expanded_ = b;
 
+    invalidateCache();
+
     placeWidgets();
   }
 }
@@ -130,7 +155,7 @@ void
 Widget::
 placeWidgets()
 {
-  area()->placeWidgets();
+  area()->schedulePlaceWidgets();
 }
 
 void
@@ -263,6 +288,9 @@ setNameValue(const QString &name, const QVariant &value)
   if (! ok)
     return false;
 
+  // scheduled (merged with other changes in same event loop turn)
+  placeWidgets();
+
   return true;
 }
 
@@ -443,10 +471,7 @@ mouseMoveEvent(QMouseEvent *e)
       this->setX(mouseData_.dragX + dx);
       this->setY(mouseData_.dragY + dy);
 
-      int xo = area()->xOffset();
-      int yo = area()->yOffset();
-
-      this->move(this->x() + xo, this->y() + yo);
+      this->move(this->x(), this->y());
     }
     else {
 #if 0
@@ -523,16 +548,25 @@ Widget::
 contentsMousePress(QMouseEvent *e)
 {
   if (e->button() == Qt::LeftButton) {
+    // repaint lines of previous selection
+    if (mouseData_.pressLineNum != mouseData_.moveLineNum ||
+        mouseData_.pressCharNum != mouseData_.moveCharNum)
+      updateLineRange(mouseData_.pressLineNum, mouseData_.moveLineNum);
+
     (void) pixelToText(e->pos(), mouseData_.pressLineNum, mouseData_.pressCharNum);
 
     mouseData_.pressed     = true;
     mouseData_.moveLineNum = mouseData_.pressLineNum;
     mouseData_.moveCharNum = mouseData_.pressCharNum;
+
+    invalidateCache();
   }
   else if (e->button() == Qt::MiddleButton) {
     paste();
 
-    update();
+    invalidateCache();
+
+    scheduleUpdate();
   }
 }
 
@@ -541,9 +575,18 @@ Widget::
 contentsMouseMove(QMouseEvent *e)
 {
   if (mouseData_.pressed) {
+    int lineNum = mouseData_.moveLineNum;
+    int charNum = mouseData_.moveCharNum;
+
     (void) pixelToText(e->pos(), mouseData_.moveLineNum, mouseData_.moveCharNum);
 
-    update();
+    if (lineNum == mouseData_.moveLineNum && charNum == mouseData_.moveCharNum)
+      return;
+
+    invalidateCache();
+
+    // selection only changes on lines between old and new end
+    updateLineRange(lineNum, mouseData_.moveLineNum);
   }
 }
 
@@ -551,9 +594,12 @@ void
 Widget::
 contentsMouseRelease(QMouseEvent *e)
 {
-  if (mouseData_.pressed)
+  if (mouseData_.pressed) {
     (void) pixelToText(e->pos(), mouseData_.moveLineNum, mouseData_.moveCharNum);
 
+    invalidateCache();
+  }
+
   mouseData_.reset();
 }
 
@@ -588,6 +634,36 @@ pixelToText(const QPoint &p, int &lineNum, int &charNum)
   return false;
 }
 
+QRect
+Widget::
+lineRect(int lineNum) const
+{
+  int numLines = int(lines_.size());
+
+  if (lineNum < 0 || lineNum >= numLines)
+    return QRect();
+
+  auto *line = lines_[size_t(lineNum)];
+
+  return QRect(0, line->y(), contents_->width(), charData_.height);
+}
+
+void
+Widget::
+updateLineRange(int lineNum1, int lineNum2)
+{
+  auto r1 = lineRect(lineNum1);
+  auto r2 = lineRect(lineNum2);
+
+  // update all if line not drawn
+  if (! r1.isValid() || ! r2.isValid()) {
+    contentsUpdateSlot();
+    return;
+  }
+
+  contents_->update(r1.united(r2));
+}
+
 void
 Widget::
 updateSize()
@@ -601,15 +677,59 @@ updateSize()
   scrollArea_->showVBar(QFrame::height() < size.height());
 }
 
+QPoint
+Widget::
+contentsOffset() const
+{
+  return QPoint(scrollArea_->getXOffset(), scrollArea_->getYOffset());
+}
+
+void
+Widget::
+releasePayload()
+{
+  // keep layout size while spilled
+  spillSizeHint_ = contentsSizeHint();
+  spillSize_     = contentsSize();
+
+  freePayload();
+
+  spilled_ = true;
+
+  invalidateCache();
+}
+
+bool
+Widget::
+restorePayload(QDataStream &is)
+{
+  // stay spilled if read fails (restore retried by next loadPayload)
+  if (! readPayload(is))
+    return false;
+
+  spilled_ = false;
+
+  invalidateCache();
+
+  return true;
+}
+
+void
+Widget::
+loadPayload() const
+{
+  if (spilled_)
+    (void) frame()->memoryMgr()->restore(const_cast<Widget *>(this));
+}
+
 void
 Widget::
 drawContents(QPainter *painter)
 {
   if (isExpanded()) {
-    int dx = scrollArea_->getXOffset();
-    int dy = scrollArea_->getYOffset();
+    auto offset = contentsOffset();
 
-    draw(painter, dx, dy);
+    draw(painter, offset.x(), offset.y());
   }
 }
 
@@ -676,6 +796,8 @@ updateFont()
   charData_.height  = fm.height();
   charData_.ascent  = fm.ascent();
 //charData_.descent = fm.descent();
+
+  invalidateCache();
 }
 
 void
@@ -874,13 +996,83 @@ WidgetContents(Widget *widget) :
   setMouseTracking(true);
 }
 
+WidgetContents::
+~WidgetContents()
+{
+  if (! cache_.isNull())
+    RasterCache::instance()->remove(this);
+}
+
 void
 WidgetContents::
-paintEvent(QPaintEvent *)
+paintEvent(QPaintEvent *e)
 {
+  // mark viewed for memory budget (restores spilled payload)
+  widget_->frame()->memoryMgr()->touch(widget_);
+
   QPainter painter(this);
 
+  auto *cache = RasterCache::instance();
+
+  // draw damaged area directly if not cached or contents changing interactively
+  if (! cache->isEnabled() || ! widget_->canCache() || widget_->isSelecting() ||
+      width() <= 0 || height() <= 0) {
+    painter.setClipRegion(e->region());
+
+    widget_->drawContents(&painter);
+
+    return;
+  }
+
+  //---
+
+  // redraw cached pixmap if contents, scroll offset or size changed
+  if (cache_.isNull() || cacheVersion_ != widget_->contentsVersion() ||
+      cacheOffset_ != widget_->contentsOffset() || cacheSize_ != size())
+    updateCache();
+  else
+    cache->touch(this);
+
+  painter.drawPixmap(0, 0, cache_);
+}
+
+void
+WidgetContents::
+updateCache()
+{
+  qreal dpr = devicePixelRatioF();
+
+  cache_ = QPixmap(size()*dpr);
+
+  cache_.setDevicePixelRatio(dpr);
+
+  cache_.fill(Qt::transparent);
+
+  QPainter painter(&cache_);
+
+  painter.setFont(font());
+  painter.setPen (palette().color(QPalette::WindowText));
+
   widget_->drawContents(&painter);
+
+  painter.end();
+
+  cacheVersion_ = widget_->contentsVersion();
+  cacheOffset_  = widget_->contentsOffset();
+  cacheSize_    = size();
+
+  qint64 bytes = qint64(cache_.width())*qint64(cache_.height())*(cache_.depth()/8);
+
+  RasterCache::instance()->add(this, bytes);
+}
+
+void
+WidgetContents::
+releaseCache()
+{
+  cache_ = QPixmap();
+
+  cacheVersion_ = -1;
 }
 
 void
@@ -918,6 +1110,9 @@ sizeHint() const
   if (! widget_->isExpanded())
     return QSize(-1, 20);
 
+  if (widget_->isSpilled())
+    return widget_->spillSizeHint();
+
   return widget_->contentsSizeHint();
 }
 
@@ -928,6 +1123,9 @@ contentsSize() const
   if (! widget_->isExpanded())
     return QSize(-1, 20);
 
+  if (widget_->isSpilled())
+    return widget_->spillSize();
+
   return widget_->contentsSize();
 }
 
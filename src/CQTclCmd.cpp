@@ -1,6 +1,9 @@
 #include <CQTclCmd.h>
 #include <CQTclUtil.h>
+#include <CTclVector.h>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 
 namespace CQTclCmd {
 
@@ -30,6 +33,8 @@ addCommand(const QString &name, CmdProc *proc)
   commandNames_.push_back(name);
 
   commandProcs_[name] = proc;
+
+  commandTrie_.add(name);
 }
 
 bool
@@ -41,13 +46,24 @@ processCmd(const QString &name, const Vars &vars)
   if (p != commandProcs_.end()) {
     auto *proc = (*p).second;
 
-    auto *args = createArgs(name, vars);
+    return execCmd(proc, createArgs(name, vars));
+  }
 
-    bool rc = proc->exec(*args);
+  //---
 
-    delete args;
+  return false;
+}
+
+bool
+Mgr::
+processCmd(const QString &name, int objc, const Tcl_Obj **objv)
+{
+  auto p = commandProcs_.find(name);
+
+  if (p != commandProcs_.end()) {
+    auto *proc = (*p).second;
 
-    return rc;
+    return execCmd(proc, createArgs(name, objc, objv));
   }
 
   //---
@@ -55,6 +71,37 @@ processCmd(const QString &name, const Vars &vars)
   return false;
 }
 
+bool
+Mgr::
+execCmd(CmdProc *proc, CmdArgs *args)
+{
+  args->setSchema(proc->schema());
+
+  bool rc;
+
+  if (isProfiling()) {
+    using Clock = std::chrono::steady_clock;
+
+    args->setTimed(true);
+
+    auto t1 = Clock::now();
+
+    rc = proc->exec(*args);
+
+    auto t2 = Clock::now();
+
+    auto totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+
+    proc->stats().add(args->parseNs(), int64_t(totalNs));
+  }
+  else
+    rc = proc->exec(*args);
+
+  delete args;
+
+  return rc;
+}
+
 CmdProc *
 Mgr::
 getCommand(const QString &name) const
@@ -78,6 +125,13 @@ createArgs(const QString &name, const Vars &vars)
   return new CmdArgs(name, vars);
 }
 
+CmdArgs *
+Mgr::
+createArgs(const QString &name, int objc, const Tcl_Obj **objv)
+{
+  return new CmdArgs(name, qtcl_->interp(), objc, objv);
+}
+
 bool
 Mgr::
 help(const QString &pattern, bool verbose, bool hidden)
@@ -111,7 +165,7 @@ help(const QString &pattern, bool verbose, bool hidden)
 
       auto *args = createArgs(proc->name(), vars);
 
-      proc->addArgs(*args);
+      args->setSchema(proc->schema());
 
       args->help(hidden);
 
@@ -125,6 +179,107 @@ help(const QString &pattern, bool verbose, bool hidden)
   return true;
 }
 
+QStringList
+Mgr::
+matchCommands(const QString &prefix) const
+{
+  return commandTrie_.match(prefix);
+}
+
+QString
+Mgr::
+completeCommand(const QString &prefix, bool &exact) const
+{
+  return commandTrie_.longestMatch(prefix, exact);
+}
+
+QStringList
+Mgr::
+matchOptions(const QString &command, const QString &prefix) const
+{
+  auto *proc = getCommand(command);
+  if (! proc) return QStringList();
+
+  return proc->schema()->optTrie().match(prefix);
+}
+
+QString
+Mgr::
+completeOption(const QString &command, const QString &prefix, bool &exact) const
+{
+  exact = false;
+
+  auto *proc = getCommand(command);
+  if (! proc) return QString();
+
+  return proc->schema()->optTrie().longestMatch(prefix, exact);
+}
+
+QStringList
+Mgr::
+optionValues(const QString &command, const QString &option,
+             const NameValueMap &nameValueMap) const
+{
+  auto *proc = getCommand(command);
+  if (! proc) return QStringList();
+
+  const auto &schema = proc->schema();
+
+  int slot = schema->optSlot(option);
+  if (slot < 0) return QStringList();
+
+  // fixed values (enum, string bool)
+  auto *trie = schema->valueTrie(slot);
+
+  if (trie)
+    return trie->match("");
+
+  // command supplied values for strings
+  const auto &cmdArg = schema->cmdArgs()[size_t(slot)];
+
+  if (cmdArg.type() == int(CmdArg::Type::String))
+    return proc->getArgValues(option, nameValueMap);
+
+  return QStringList();
+}
+
+QString
+Mgr::
+completeValue(const QString &command, const QString &option, const QString &prefix,
+              const NameValueMap &nameValueMap, bool &exact) const
+{
+  exact = false;
+
+  auto *proc = getCommand(command);
+  if (! proc) return QString();
+
+  const auto &schema = proc->schema();
+
+  int slot = schema->optSlot(option);
+  if (slot < 0) return QString();
+
+  auto *trie = schema->valueTrie(slot);
+
+  if (trie)
+    return trie->longestMatch(prefix, exact);
+
+  // values depend on other option values so trie built for request
+  NameTrie valueTrie;
+
+  for (const auto &value : optionValues(command, option, nameValueMap))
+    valueTrie.add(value);
+
+  return valueTrie.longestMatch(prefix, exact);
+}
+
+void
+Mgr::
+resetProfile()
+{
+  for (auto &p : commandProcs_)
+    p.second->stats().reset();
+}
+
 void
 Mgr::
 helpAll(bool verbose, bool hidden)
@@ -138,7 +293,7 @@ helpAll(bool verbose, bool hidden)
 
       auto *args = createArgs(proc->name(), vars);
 
-      proc->addArgs(*args);
+      args->setSchema(proc->schema());
 
       args->help(hidden);
 
@@ -152,6 +307,40 @@ helpAll(bool verbose, bool hidden)
 
 //------
 
+void
+CmdStats::
+add(int64_t parseNs, int64_t totalNs)
+{
+  count_  .fetch_add(1      , std::memory_order_relaxed);
+  totalNs_.fetch_add(totalNs, std::memory_order_relaxed);
+  parseNs_.fetch_add(parseNs, std::memory_order_relaxed);
+
+  auto minNs = minNs_.load(std::memory_order_relaxed);
+
+  while (totalNs < minNs &&
+         ! minNs_.compare_exchange_weak(minNs, totalNs, std::memory_order_relaxed))
+    ;
+
+  auto maxNs = maxNs_.load(std::memory_order_relaxed);
+
+  while (totalNs > maxNs &&
+         ! maxNs_.compare_exchange_weak(maxNs, totalNs, std::memory_order_relaxed))
+    ;
+}
+
+void
+CmdStats::
+reset()
+{
+  count_  .store(0        , std::memory_order_relaxed);
+  totalNs_.store(0        , std::memory_order_relaxed);
+  parseNs_.store(0        , std::memory_order_relaxed);
+  minNs_  .store(INT64_MAX, std::memory_order_relaxed);
+  maxNs_  .store(0        , std::memory_order_relaxed);
+}
+
+//------
+
 CmdArg::
 CmdArg(int ind, const QString &name, int type, const QString &argDesc, const QString &desc) :
  ind_(ind), name_(name), type_(type), argDesc_(argDesc), desc_(desc)
@@ -181,12 +370,252 @@ CmdGroup(int ind, Type type) :
 
 //---
 
+CmdSchema::
+CmdSchema(const CmdArgArray &cmdArgs, const CmdGroups &cmdGroups) :
+ cmdArgs_(cmdArgs), cmdGroups_(cmdGroups)
+{
+  int slot = 0;
+
+  for (const auto &cmdArg : cmdArgs_) {
+    if (cmdArg.isOpt()) {
+      optSlots_[cmdArg.name()] = slot;
+
+      if (! cmdArg.isHidden())
+        optTrie_.add(cmdArg.name());
+
+      // fixed values
+      if      (cmdArg.type() == int(CmdArg::Type::Enum)) {
+        auto &trie = valueTries_[slot];
+
+        for (const auto &nv : cmdArg.nameValues())
+          trie.add(nv.first);
+      }
+      else if (cmdArg.type() == int(CmdArg::Type::SBool)) {
+        auto &trie = valueTries_[slot];
+
+        trie.add("0");
+        trie.add("1");
+      }
+    }
+
+    ++slot;
+  }
+}
+
+const NameTrie *
+CmdSchema::
+valueTrie(int slot) const
+{
+  auto p = valueTries_.find(slot);
+
+  return (p != valueTries_.end() ? &(*p).second : nullptr);
+}
+
+//---
+
+NameTrie::
+NameTrie()
+{
+  // root node
+  nodes_.emplace_back();
+}
+
+void
+NameTrie::
+add(const QString &name)
+{
+  if (contains(name))
+    return;
+
+  int ind = 0;
+
+  ++nodes_[0].count;
+
+  for (const auto &c : name) {
+    auto p = nodes_[size_t(ind)].children.find(c);
+
+    int ind1;
+
+    if (p == nodes_[size_t(ind)].children.end()) {
+      ind1 = int(nodes_.size());
+
+      nodes_.emplace_back();
+
+      nodes_[size_t(ind)].children[c] = ind1;
+    }
+    else
+      ind1 = (*p).second;
+
+    ind = ind1;
+
+    ++nodes_[size_t(ind)].count;
+  }
+
+  nodes_[size_t(ind)].terminal = true;
+}
+
+bool
+NameTrie::
+remove(const QString &name)
+{
+  if (! contains(name))
+    return false;
+
+  // nodes left in place (empty subtrees skipped by count)
+  int ind = 0;
+
+  --nodes_[0].count;
+
+  for (const auto &c : name) {
+    ind = nodes_[size_t(ind)].children[c];
+
+    --nodes_[size_t(ind)].count;
+  }
+
+  nodes_[size_t(ind)].terminal = false;
+
+  return true;
+}
+
+bool
+NameTrie::
+contains(const QString &name) const
+{
+  int ind = findNode(name);
+
+  return (ind >= 0 && nodes_[size_t(ind)].terminal);
+}
+
+QStringList
+NameTrie::
+match(const QString &prefix) const
+{
+  QStringList names;
+
+  int ind = findNode(prefix);
+
+  if (ind >= 0) {
+    auto name = prefix;
+
+    addNames(ind, name, names);
+  }
+
+  return names;
+}
+
+QString
+NameTrie::
+longestMatch(const QString &prefix, bool &exact) const
+{
+  exact = false;
+
+  int ind = findNode(prefix);
+
+  if (ind < 0)
+    return QString();
+
+  // extend while single path (stop at end of name)
+  auto name = prefix;
+
+  while (! nodes_[size_t(ind)].terminal) {
+    int  ind1 = -1;
+    QChar c1;
+
+    for (const auto &pc : nodes_[size_t(ind)].children) {
+      if (nodes_[size_t(pc.second)].count == 0)
+        continue;
+
+      if (ind1 >= 0) {
+        ind1 = -1;
+        break;
+      }
+
+      ind1 = pc.second;
+      c1   = pc.first;
+    }
+
+    if (ind1 < 0)
+      break;
+
+    name += c1;
+
+    ind = ind1;
+  }
+
+  exact = (nodes_[size_t(ind)].terminal && nodes_[size_t(ind)].count == 1);
+
+  return name;
+}
+
+int
+NameTrie::
+findNode(const QString &prefix) const
+{
+  int ind = 0;
+
+  for (const auto &c : prefix) {
+    const auto &children = nodes_[size_t(ind)].children;
+
+    auto p = children.find(c);
+
+    if (p == children.end())
+      return -1;
+
+    ind = (*p).second;
+  }
+
+  if (nodes_[size_t(ind)].count == 0)
+    return -1;
+
+  return ind;
+}
+
+void
+NameTrie::
+addNames(int ind, QString &name, QStringList &names) const
+{
+  const auto &node = nodes_[size_t(ind)];
+
+  if (node.terminal)
+    names.push_back(name);
+
+  for (const auto &pc : node.children) {
+    if (nodes_[size_t(pc.second)].count == 0)
+      continue;
+
+    name += pc.first;
+
+    addNames(pc.second, name, names);
+
+    name.chop(1);
+  }
+}
+
+//---
+
 CmdArgs::
 CmdArgs(const QString &cmdName, const Args &argv) :
  cmdName_(cmdName), argv_(argv), argc_(int(argv_.size()))
 {
 }
 
+CmdArgs::
+CmdArgs(const QString &cmdName, Tcl_Interp *interp, int objc, const Tcl_Obj **objv) :
+ cmdName_(cmdName), interp_(interp), argc_(objc)
+{
+  objv_.resize(size_t(objc));
+
+  for (int i = 0; i < objc; ++i)
+    objv_[size_t(i)] = const_cast<Tcl_Obj *>(objv[i]);
+}
+
+CmdArgs::
+~CmdArgs()
+{
+  for (auto *obj : ownedObjs_)
+    Tcl_DecrRefCount(obj);
+}
+
 CmdGroup &
 CmdArgs::
 startCmdGroup(CmdGroup::Type type)
@@ -246,17 +675,71 @@ getArg()
 {
   assert(i_ < argc_);
 
-  lastArg_ = Arg(argv_[size_t(i_++)]);
+  if (isObjArgs())
+    lastArg_ = Arg(interp_, objv_[size_t(i_++)]);
+  else
+    lastArg_ = Arg(argv_[size_t(i_++)]);
 
   return lastArg_;
 }
 
+Tcl_Obj *
+CmdArgs::
+nextObj()
+{
+  if (eof()) return nullptr;
+
+  return objv_[size_t(i_++)];
+}
+
+Tcl_Obj *
+CmdArgs::
+getOptObj()
+{
+  if (isObjArgs())
+    return nextObj();
+
+  if (eof()) return nullptr;
+
+  // keep created object alive for parsed value
+  auto *obj = CQTclUtil::variantToObj(nullptr, argv_[size_t(i_++)]);
+
+  Tcl_IncrRefCount(obj);
+
+  ownedObjs_.push_back(obj);
+
+  return obj;
+}
+
 //---
 
 bool
 CmdArgs::
 getOptValue(QStringList &strs)
 {
+  if (isObjArgs()) {
+    auto *obj = nextObj();
+    if (! obj) return false;
+
+    // list object gives elements, otherwise single string (as variant args)
+    static const Tcl_ObjType *ltype = Tcl_GetObjType("list");
+
+    if (obj->typePtr == ltype) {
+      int       n    = 0;
+      Tcl_Obj **objs = nullptr;
+
+      if (Tcl_ListObjGetElements(interp_, obj, &n, &objs) != TCL_OK)
+        return false;
+
+      for (int i = 0; i < n; ++i)
+        strs.push_back(CQTclUtil::stringFromObj(objs[i]));
+    }
+    else
+      strs.push_back(CQTclUtil::stringFromObj(obj));
+
+    return true;
+  }
+
   if (eof()) return false;
 
   strs = toStringList(argv_[size_t(i_++)]);
@@ -268,6 +751,15 @@ bool
 CmdArgs::
 getOptValue(QString &str)
 {
+  if (isObjArgs()) {
+    auto *obj = nextObj();
+    if (! obj) return false;
+
+    str = CQTclUtil::stringFromObj(obj);
+
+    return true;
+  }
+
   if (eof()) return false;
 
   str = toString(argv_[size_t(i_++)]);
@@ -279,6 +771,14 @@ bool
 CmdArgs::
 getOptValue(int &i)
 {
+  // use cached internal rep
+  if (isObjArgs()) {
+    auto *obj = nextObj();
+    if (! obj) return false;
+
+    return (Tcl_GetIntFromObj(interp_, obj, &i) == TCL_OK);
+  }
+
   QString str;
 
   if (! getOptValue(str))
@@ -295,6 +795,14 @@ bool
 CmdArgs::
 getOptValue(double &r)
 {
+  // use cached internal rep
+  if (isObjArgs()) {
+    auto *obj = nextObj();
+    if (! obj) return false;
+
+    return (Tcl_GetDoubleFromObj(interp_, obj, &r) == TCL_OK);
+  }
+
   QString str;
 
   if (! getOptValue(str))
@@ -311,6 +819,17 @@ bool
 CmdArgs::
 getOptValue(OptReal &r)
 {
+  if (isObjArgs()) {
+    double r1;
+
+    if (! getOptValue(r1))
+      return false;
+
+    r = r1;
+
+    return true;
+  }
+
   QString str;
 
   if (! getOptValue(str))
@@ -346,14 +865,37 @@ getOptValue(bool &b)
 bool
 CmdArgs::
 parse(bool &rc)
+{
+  if (! isTimed())
+    return parseArgs(rc);
+
+  using Clock = std::chrono::steady_clock;
+
+  auto t1 = Clock::now();
+
+  bool b = parseArgs(rc);
+
+  auto t2 = Clock::now();
+
+  parseNs_ = int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+
+  return b;
+}
+
+bool
+CmdArgs::
+parseArgs(bool &rc)
 {
   rc = false;
 
+  // build schema for added args (if not prebuilt)
+  if (! schema_)
+    schema_ = std::make_shared<const CmdSchema>(cmdArgs_, cmdGroups_);
+
   // clear parsed values
-  parseInt_ .clear();
-  parseReal_.clear();
-  parseStr_ .clear();
-  parseBool_.clear();
+  parseValues_.clear();
+  parseValues_.resize(schema_->cmdArgs().size());
+
   parseArgs_.clear();
 
   //---
@@ -445,7 +987,7 @@ parse(bool &rc)
   //---
 
   // check options specified for cmd groups
-  for (const auto &cmdGroup : cmdGroups_) {
+  for (const auto &cmdGroup : cmdGroups()) {
     int groupInd = cmdGroup.ind();
 
     auto p = groupNames.find(groupInd);
@@ -474,22 +1016,25 @@ parse(bool &rc)
 
   // display parsed data for debug
   if (isDebug()) {
-    for (auto &pi : parseInt_) {
-      std::cerr << pi.first.toStdString() << "=" << pi.second << "\n";
-    }
-    for (auto &pr : parseReal_) {
-      std::cerr << pr.first.toStdString() << "=" << pr.second << "\n";
-    }
-    for (auto &ps : parseStr_) {
-      const QString     &name   = ps.first;
-      const QStringList &values = ps.second;
+    const auto &cmdArgs = this->cmdArgs();
+
+    for (size_t slot = 0; slot < parseValues_.size(); ++slot) {
+      const auto &value = parseValues_[slot];
 
-      for (int i = 0; i < ps.second.length(); ++i) {
-        std::cerr << name.toStdString() << "=" << values[i].toStdString() << "\n";
+      auto name = cmdArgs[slot].name().toStdString();
+
+      if      (value.type == ParseValue::Type::Integer)
+        std::cerr << name << "=" << value.i << "\n";
+      else if (value.type == ParseValue::Type::Real)
+        std::cerr << name << "=" << value.r << "\n";
+      else if (value.type == ParseValue::Type::Strings) {
+        for (int i = 0; i < value.strs.length(); ++i)
+          std::cerr << name << "=" << value.strs[i].toStdString() << "\n";
       }
-    }
-    for (auto &ps : parseBool_) {
-      std::cerr << ps.first.toStdString() << "=" << ps.second << "\n";
+      else if (value.type == ParseValue::Type::Boolean)
+        std::cerr << name << "=" << value.b << "\n";
+      else if (value.type == ParseValue::Type::Object)
+        std::cerr << name << "=<" << (value.obj->typePtr ? value.obj->typePtr->name : "") << ">\n";
     }
     for (auto &a : parseArgs_) {
       std::cerr << toString(a).toStdString() << "\n";
@@ -505,18 +1050,18 @@ parse(bool &rc)
 
 bool
 CmdArgs::
-handleParseArg(CmdArg *cmdArg, const QString &opt)
+handleParseArg(const CmdArg *cmdArg, const QString &opt)
 {
   // handle bool option (no value)
   if      (cmdArg->type() == int(CmdArg::Type::Boolean)) {
-    parseBool_[opt] = true;
+    setParseValue(cmdArg, ParseValue::Type::Boolean).b = true;
   }
   // handle integer option
   else if (cmdArg->type() == int(CmdArg::Type::Integer)) {
     int i = 0;
 
     if (getOptValue(i)) {
-      parseInt_[opt] = i;
+      setParseValue(cmdArg, ParseValue::Type::Integer).i = i;
     }
     else {
       return valueError(opt);
@@ -527,7 +1072,7 @@ handleParseArg(CmdArg *cmdArg, const QString &opt)
     double r = 0.0;
 
     if (getOptValue(r)) {
-      parseReal_[opt] = r;
+      setParseValue(cmdArg, ParseValue::Type::Real).r = r;
     }
     else {
       return valueError(opt);
@@ -539,8 +1084,10 @@ handleParseArg(CmdArg *cmdArg, const QString &opt)
       QStringList strs;
 
       if (getOptValue(strs)) {
+        auto &value = setParseValue(cmdArg, ParseValue::Type::Strings);
+
         for (int i = 0; i < strs.length(); ++i)
-          parseStr_[opt].push_back(strs[i]);
+          value.strs.push_back(strs[i]);
       }
       else
         return valueError(opt);
@@ -549,7 +1096,7 @@ handleParseArg(CmdArg *cmdArg, const QString &opt)
       QString str;
 
       if (getOptValue(str))
-        parseStr_[opt].push_back(str);
+        setParseValue(cmdArg, ParseValue::Type::Strings).strs.push_back(str);
       else
         return valueError(opt);
     }
@@ -559,7 +1106,7 @@ handleParseArg(CmdArg *cmdArg, const QString &opt)
     bool b;
 
     if (getOptValue(b)) {
-      parseBool_[opt] = b;
+      setParseValue(cmdArg, ParseValue::Type::Boolean).b = b;
     }
     else {
       return valueError(opt);
@@ -574,7 +1121,7 @@ handleParseArg(CmdArg *cmdArg, const QString &opt)
 
       for (auto &nv : cmdArg->nameValues()) {
         if (str == nv.first) {
-          parseInt_[opt] = nv.second;
+          setParseValue(cmdArg, ParseValue::Type::Integer).i = nv.second;
           found = true;
           break;
         }
@@ -593,6 +1140,15 @@ handleParseArg(CmdArg *cmdArg, const QString &opt)
       return valueError(opt);
     }
   }
+  // handle object option (value passed through unconverted)
+  else if (cmdArg->type() == int(CmdArg::Type::Object)) {
+    auto *obj = getOptObj();
+
+    if (obj)
+      setParseValue(cmdArg, ParseValue::Type::Object).obj = obj;
+    else
+      return valueError(opt);
+  }
   // invalid type (assert ?)
   else {
     std::cerr << "Invalid type for '" << opt.toStdString() << "'\n";
@@ -608,12 +1164,7 @@ bool
 CmdArgs::
 hasParseArg(const QString &name) const
 {
-  if      (parseInt_ .find(name) != parseInt_ .end()) return true;
-  else if (parseReal_.find(name) != parseReal_.end()) return true;
-  else if (parseStr_ .find(name) != parseStr_ .end()) return true;
-  else if (parseBool_.find(name) != parseBool_.end()) return true;
-
-  return false;
+  return hasParseSlot(argSlot(name));
 }
 
 //---
@@ -622,97 +1173,204 @@ int
 CmdArgs::
 getParseInt(const QString &name, int def) const
 {
-  auto p = parseInt_.find(name);
-  if (p == parseInt_.end()) return def;
-
-  return (*p).second;
+  return getSlotInt(argSlot(name), def);
 }
 
 CmdArgs::OptInt
 CmdArgs::
 getParseOptInt(const QString &name) const
 {
-  auto p = parseInt_.find(name);
-  if (p == parseInt_.end()) return OptInt();
+  auto *value = parseValue(argSlot(name), ParseValue::Type::Integer);
+  if (! value) return OptInt();
 
-  return OptInt((*p).second);
+  return OptInt(value->i);
 }
+
 double
 CmdArgs::
 getParseReal(const QString &name, double def) const
 {
-  auto p = parseReal_.find(name);
-  if (p == parseReal_.end()) return def;
-
-  return (*p).second;
+  return getSlotReal(argSlot(name), def);
 }
 
 CmdArgs::OptReal
 CmdArgs::
 getParseOptReal(const QString &name) const
 {
-  auto p = parseReal_.find(name);
-  if (p == parseReal_.end()) return OptReal();
+  auto *value = parseValue(argSlot(name), ParseValue::Type::Real);
+  if (! value) return OptReal();
 
-  return OptReal((*p).second);
+  return OptReal(value->r);
 }
 
 int
 CmdArgs::
 getNumParseStrs(const QString &name) const
 {
-  auto p = parseStr_.find(name);
-  if (p == parseStr_.end()) return 0;
+  auto *value = parseValue(argSlot(name), ParseValue::Type::Strings);
+  if (! value) return 0;
 
-  return (*p).second.size();
+  return value->strs.size();
 }
 
 QStringList
 CmdArgs::
 getParseStrs(const QString &name) const
 {
-  auto p = parseStr_.find(name);
-  if (p == parseStr_.end()) return QStringList();
-
-  return (*p).second;
+  return getSlotStrs(argSlot(name));
 }
 
 QString
 CmdArgs::
 getParseStr(const QString &name, const QString &def) const
 {
-  auto p = parseStr_.find(name);
-  if (p == parseStr_.end()) return def;
-
-  return (*p).second[0];
+  return getSlotStr(argSlot(name), def);
 }
 
 bool
 CmdArgs::
 getParseBool(const QString &name, bool def) const
 {
-  auto p = parseBool_.find(name);
-  if (p == parseBool_.end()) return def;
-
-  return (*p).second;
+  return getSlotBool(argSlot(name), def);
 }
 
 CmdArgs::OptBool
 CmdArgs::
 getParseOptBool(const QString &name) const
 {
-  auto p = parseBool_.find(name);
-  if (p == parseBool_.end()) return OptBool();
+  auto *value = parseValue(argSlot(name), ParseValue::Type::Boolean);
+  if (! value) return OptBool();
+
+  return OptBool(value->b);
+}
+
+Tcl_Obj *
+CmdArgs::
+getParseObj(const QString &name) const
+{
+  return getSlotObj(argSlot(name));
+}
+
+//---
+
+int
+CmdArgs::
+argSlot(const QString &name) const
+{
+  if (! schema_)
+    return -1;
+
+  return schema_->optSlot(name);
+}
+
+bool
+CmdArgs::
+hasParseSlot(int slot) const
+{
+  return (slot >= 0 && slot < int(parseValues_.size()) &&
+          parseValues_[size_t(slot)].type != ParseValue::Type::None);
+}
+
+int
+CmdArgs::
+getSlotInt(int slot, int def) const
+{
+  auto *value = parseValue(slot, ParseValue::Type::Integer);
+  if (! value) return def;
+
+  return value->i;
+}
+
+double
+CmdArgs::
+getSlotReal(int slot, double def) const
+{
+  auto *value = parseValue(slot, ParseValue::Type::Real);
+  if (! value) return def;
+
+  return value->r;
+}
+
+QStringList
+CmdArgs::
+getSlotStrs(int slot) const
+{
+  auto *value = parseValue(slot, ParseValue::Type::Strings);
+  if (! value) return QStringList();
 
-  return OptBool((*p).second);
+  return value->strs;
+}
+
+QString
+CmdArgs::
+getSlotStr(int slot, const QString &def) const
+{
+  auto *value = parseValue(slot, ParseValue::Type::Strings);
+  if (! value) return def;
+
+  return value->strs[0];
+}
+
+bool
+CmdArgs::
+getSlotBool(int slot, bool def) const
+{
+  auto *value = parseValue(slot, ParseValue::Type::Boolean);
+  if (! value) return def;
+
+  return value->b;
+}
+
+Tcl_Obj *
+CmdArgs::
+getSlotObj(int slot) const
+{
+  auto *value = parseValue(slot, ParseValue::Type::Object);
+  if (! value) return nullptr;
+
+  return value->obj;
+}
+
+const CmdArgs::ParseValue *
+CmdArgs::
+parseValue(int slot, ParseValue::Type type) const
+{
+  if (slot < 0 || slot >= int(parseValues_.size()))
+    return nullptr;
+
+  const auto &value = parseValues_[size_t(slot)];
+
+  if (value.type != type)
+    return nullptr;
+
+  return &value;
+}
+
+CmdArgs::ParseValue &
+CmdArgs::
+setParseValue(const CmdArg *cmdArg, ParseValue::Type type)
+{
+  // arg ind is one based position in schema args
+  auto &value = parseValues_[size_t(cmdArg->ind() - 1)];
+
+  value.type = type;
+
+  return value;
 }
 
 //---
 
-CmdArg *
+const CmdArg *
 CmdArgs::
-getCmdOpt(const QString &name)
+getCmdOpt(const QString &name) const
 {
+  // prebuilt slot lookup
+  if (schema_) {
+    int slot = schema_->optSlot(name);
+
+    return (slot >= 0 ? &schema_->cmdArgs()[size_t(slot)] : nullptr);
+  }
+
   for (auto &cmdArg : cmdArgs_) {
     if (cmdArg.isOpt() && cmdArg.name() == name)
       return &cmdArg;
@@ -729,7 +1387,7 @@ getCmdArgNames() const
 {
   QStringList names;
 
-  for (auto &cmdArg : cmdArgs_) {
+  for (auto &cmdArg : cmdArgs()) {
     if (cmdArg.isOpt())
       names.push_back("-" + cmdArg.name());
   }
@@ -771,7 +1429,7 @@ help(bool showHidden) const
 
   std::cerr << cmdName_.toStdString() << "\n";
 
-  for (auto &cmdArg : cmdArgs_) {
+  for (auto &cmdArg : cmdArgs()) {
     if (! showHidden && cmdArg.isHidden())
       continue;
 
@@ -816,7 +1474,7 @@ helpGroup(int groupInd, bool showHidden) const
 {
   assert(groupInd > 0);
 
-  const CmdGroup &cmdGroup = cmdGroups_[size_t(groupInd - 1)];
+  const CmdGroup &cmdGroup = cmdGroups()[size_t(groupInd - 1)];
 
   if (! cmdGroup.isRequired())
     std::cerr << "[";
@@ -897,9 +1555,7 @@ toString(const QVariant &var)
       strs.push_back(str);
     }
 
-    CQTcl tcl;
-
-    return tcl.mergeList(strs);
+    return CQTclUtil::mergeList(strs);
   }
   else
     return var.toString();
@@ -948,7 +1604,7 @@ void
 CmdArgs::
 getGroupCmdArgs(int groupInd, CmdArgArray &cmdArgs) const
 {
-  for (auto &cmdArg : cmdArgs_) {
+  for (auto &cmdArg : cmdArgs()) {
     int groupInd1 = cmdArg.groupInd();
 
     if (groupInd1 != groupInd)
@@ -976,6 +1632,59 @@ Arg(const QVariant &var) :
   isOpt_ = (varStr.length() && varStr[0] == '-');
 }
 
+CmdArgs::Arg::
+Arg(Tcl_Interp *interp, Tcl_Obj *obj) :
+ interp_(interp), obj_(obj)
+{
+  // non-negative numbers are never options (avoids generating string rep)
+  // (negative numbers fall through so option check matches string form)
+  static const Tcl_ObjType *itype = Tcl_GetObjType("int");
+  static const Tcl_ObjType *rtype = Tcl_GetObjType("double");
+
+  if      (obj_->typePtr == itype) {
+    Tcl_WideInt i = 0;
+
+    if (Tcl_GetWideIntFromObj(nullptr, obj_, &i) == TCL_OK && i >= 0)
+      return;
+  }
+  else if (obj_->typePtr == rtype) {
+    double r = 0.0;
+
+    if (Tcl_GetDoubleFromObj(nullptr, obj_, &r) == TCL_OK && ! std::signbit(r))
+      return;
+  }
+  else if (CTclVector::isVector(obj_)) {
+    // string rep starts with first value
+    auto *vector = CTclVector::getVector(nullptr, obj_);
+
+    if (vector->size() == 0 || ! std::signbit(vector->value(0)))
+      return;
+  }
+
+  const char *str = Tcl_GetString(obj_);
+
+  isOpt_ = (str[0] == '-');
+}
+
+QString
+CmdArgs::Arg::
+opt() const
+{
+  assert(isOpt_);
+
+  if (obj_)
+    return CQTclUtil::stringFromObj(obj_).mid(1);
+
+  return toString(var_).mid(1);
+}
+
+QVariant
+CmdArgs::Arg::
+objVar() const
+{
+  return CQTclUtil::variantFromObj(interp_, obj_);
+}
+
 //------
 
 Cmd::
@@ -1002,17 +1711,8 @@ int
 Cmd::
 exec(int objc, const Tcl_Obj **objv)
 {
-  auto *qtcl = mgr_->qtcl();
-
-  Vars vars;
-
-  for (int i = 1; i < objc; ++i) {
-    auto *obj = const_cast<Tcl_Obj *>(objv[i]);
-
-    vars.push_back(qtcl->variantFromObj(obj));
-  }
-
-  if (! mgr_->processCmd(name_, vars))
+  // pass Tcl objects (skip command name) directly to args
+  if (! mgr_->processCmd(name_, objc - 1, objv + 1))
     return TCL_ERROR;
 
   return TCL_OK;
@@ -1026,6 +1726,22 @@ CmdProc(Mgr *mgr) :
 {
 }
 
+const CmdSchemaP &
+CmdProc::
+schema()
+{
+  // arguments are fixed for a proc so build once and share with each call
+  if (! schema_) {
+    CmdArgs args(name_, CmdArgs::Args());
+
+    addArgs(args);
+
+    schema_ = std::make_shared<const CmdSchema>(args.cmdArgs(), args.cmdGroups());
+  }
+
+  return schema_;
+}
+
 //------
 
 }
@@ -0,0 +1,219 @@
+#include <CTclIncrParse.h>
+#include <CTclScan.h>
+#include <algorithm>
+#include <cctype>
+
+CTclIncrParse::
+CTclIncrParse()
+{
+}
+
+void
+CTclIncrParse::
+setText(const std::string &text)
+{
+  int len1 = int(text_.size());
+  int len2 = int(text .size());
+
+  // common prefix
+  int i1 = 0;
+
+  while (i1 < len1 && i1 < len2 && text_[i1] == text[i1])
+    ++i1;
+
+  if (i1 == len1 && i1 == len2)
+    return;
+
+  // common suffix (not overlapping prefix)
+  int n = 0;
+
+  while (n < len1 - i1 && n < len2 - i1 && text_[len1 - n - 1] == text[len2 - n - 1])
+    ++n;
+
+  replace(i1, len1 - i1 - n, text.substr(i1, len2 - i1 - n));
+}
+
+void
+CTclIncrParse::
+replace(int pos, int len, const std::string &str)
+{
+  int n = int(text_.size());
+
+  pos = std::min(std::max(pos, 0), n);
+  len = std::min(std::max(len, 0), n - pos);
+
+  text_.replace(pos, len, str);
+
+  // cached tokens may reference replaced text
+  tokens_.clear();
+
+  tokenStart_ = -1;
+  tokenEnd_   = -1;
+
+  //---
+
+  // text before start of command containing edit is unchanged
+  int ind = commandInd(pos);
+
+  // old command starts after edit (resync points)
+  Starts oldStarts(starts_.begin() + ind + 1, starts_.end());
+
+  starts_.resize(ind + 1);
+
+  scan(ind, pos + len, int(str.size()) - len, oldStarts);
+}
+
+void
+CTclIncrParse::
+scan(int ind, int editEnd, int delta, const Starts &oldStarts)
+{
+  // same rules as CTclScan::isComplete (escaped chars skipped, nested
+  // brackets/braces/quotes closed by matching char) except that array variable
+  // indices outside braces are skipped to their matching ')' (as parser). An
+  // unterminated index leaves text incomplete so starts only depend on text before
+  // them (needed for resync)
+  int start = starts_[ind];
+  int n     = int(text_.size());
+
+  // old starts at or after end of edit have unchanged text after them
+  auto po = std::lower_bound(oldStarts.begin(), oldStarts.end(), editEnd);
+
+  std::string endChars;
+
+  int i = start;
+
+  while (i < n) {
+    // skip to next structural char
+    i = int(CTclScan::findNext(text_.data(), size_t(i), size_t(n)));
+
+    if (i >= n)
+      break;
+
+    char c = text_[i];
+
+    if (endChars.empty() && (c == '\n' || c == ';')) {
+      ++i;
+
+      // rest unchanged if new command start matches old one
+      while (po != oldStarts.end() && *po + delta < i)
+        ++po;
+
+      if (po != oldStarts.end() && *po + delta == i) {
+        for ( ; po != oldStarts.end(); ++po)
+          starts_.push_back(*po + delta);
+
+        numScanned_ = i - start;
+
+        return;
+      }
+
+      starts_.push_back(i);
+
+      continue;
+    }
+
+    if (c == '$' && endChars.find('}') == std::string::npos) {
+      int end;
+
+      if (arrayIndex(i + 1, end)) {
+        // unterminated index is open to end of text
+        if (end < 0) {
+          endChars.push_back(')');
+          break;
+        }
+
+        i = end;
+
+        continue;
+      }
+    }
+
+    if      (c == '[')
+      endChars.push_back(']');
+    else if (c == '{')
+      endChars.push_back('}');
+    else if (! endChars.empty() && c == endChars.back())
+      endChars.pop_back();
+    else if (c == '\"' || c == '\'')
+      endChars.push_back(c);
+    else if (c == '\\')
+      ++i;
+
+    ++i;
+  }
+
+  numScanned_ = n - start;
+
+  complete_ = endChars.empty();
+}
+
+bool
+CTclIncrParse::
+arrayIndex(int pos, int &end) const
+{
+  // $name(index) - index is read to matching ')' (nested parens counted, no other
+  // chars special) so it can contain command separators
+  int n = int(text_.size());
+
+  while (pos < n && (isalnum((unsigned char) text_[pos]) || text_[pos] == '_' ||
+                     text_[pos] == ':'))
+    ++pos;
+
+  if (pos >= n || text_[pos] != '(')
+    return false;
+
+  int depth = 0;
+
+  for ( ; pos < n; ++pos) {
+    if      (text_[pos] == '(')
+      ++depth;
+    else if (text_[pos] == ')') {
+      if (--depth == 0) {
+        end = pos + 1;
+        return true;
+      }
+    }
+  }
+
+  end = -1;
+
+  return true;
+}
+
+int
+CTclIncrParse::
+commandInd(int pos) const
+{
+  // last command starting at or before pos
+  auto p = std::upper_bound(starts_.begin(), starts_.end(), pos);
+
+  return std::max(int(p - starts_.begin()) - 1, 0);
+}
+
+void
+CTclIncrParse::
+commandRange(int pos, int &start, int &end) const
+{
+  int ind = commandInd(pos);
+
+  start = starts_[ind];
+  end   = (ind + 1 < numCommands() ? starts_[ind + 1] : int(text_.size()));
+}
+
+const CTclIncrParse::Tokens &
+CTclIncrParse::
+commandTokens(int pos, int &start, int &end)
+{
+  commandRange(pos, start, end);
+
+  if (start != tokenStart_ || end != tokenEnd_) {
+    tokens_.clear();
+
+    (void) parse_.parseString(text_.substr(start, end - start), tokens_);
+
+    tokenStart_ = start;
+    tokenEnd_   = end;
+  }
+
+  return tokens_;
+}
@@ -1,31 +1,20 @@
 #include <CTclParse.h>
-#include <CStrParse.h>
+#include <CTclScan.h>
 #include <CStrUtil.h>
 #include <CFile.h>
 #include <map>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <atomic>
 #include <cmath>
 #include <cassert>
 
-class CTclStrParse : public CStrParse {
- public:
-  CTclStrParse(CTclParse *tcl, const std::string &filename);
- ~CTclStrParse();
-
-  bool eof() const override;
-
- private:
-  bool fillBuffer();
-
- private:
-  CTclParse* tcl_        { nullptr };
-  CFile*     file_       { nullptr };
-  int        filePos_    { 0 };
-  int        lineNum_    { 0 };
-  int        lineOffset_ { 0 };
-};
-
-//------
-
 CTclParse::
 CTclParse()
 {
@@ -40,9 +29,75 @@ bool
 CTclParse::
 isCompleteLine(const std::string &line)
 {
-  startStringParse(line);
+  return CTclScan::isComplete(line.data(), line.size());
+}
+
+bool
+CTclParse::
+parseFile(const std::string &filename, Tokens &tokens)
+{
+  if (! CFile::isRegular(filename)) {
+    std::cerr << "Invalid file " << filename << "\n";
+    return false;
+  }
+
+#ifdef DEBUG_LINES
+  CFile::toLines(filename, fileLines_);
+#endif
+
+  // release tokens of previous parse
+  index_.clear();
+
+  arena_.clear();
+
+  // parse chunks of large files in parallel
+  int numThreads = numThreads_;
+
+  if (numThreads == 0)
+    numThreads = std::max(int(std::thread::hardware_concurrency()), 1);
+
+  if (numThreads > 1) {
+    auto numTokens = tokens.size();
+
+    if (parseFileParallel(filename, numThreads, tokens)) {
+      index_.build(tokens);
+
+      return true;
+    }
+
+    // fallback to serial parse
+    tokens.resize(numTokens);
+
+    arena_.clear();
+  }
+
+  startFileParse(filename);
+
+  bool rc = true;
+
+  Tokens tokens1;
+
+  while (! parse_->eof()) {
+    tokens1.clear();
+
+    try {
+      if (! readArgList(tokens1)) {
+        rc = false;
+        break;
+      }
+
+      for (auto &token1 : tokens1)
+        tokens.push_back(token1);
+    }
+    catch (...) {
+      break;
+    }
+  }
+
+  // token spans reference parsed text
+  arena_.setSource(parse_->takeSource());
 
-  bool rc = isCompleteLine1('\0');
+  index_.build(tokens);
 
   endParse();
 
@@ -51,86 +106,223 @@ isCompleteLine(const std::string &line)
 
 bool
 CTclParse::
-isCompleteLine1(char endChar)
+parseFileParallel(const std::string &filename, int numThreads, Tokens &tokens)
 {
-  while (! parse_->eof()) {
-    if      (parse_->isChar('[')) {
-      parse_->skipChar();
+  CTclSource source;
 
-      if (! isCompleteLine1(']'))
-        return false;
+  if (! source.mapFile(filename))
+    return false;
 
-      if (! parse_->isChar(']'))
-        return false;
+  // split at top level newlines (several chunks per thread to balance load)
+  const int minChunkSize = 65536;
 
-      parse_->skipChar();
-    }
-    else if (parse_->isChar('{')) {
-      parse_->skipChar();
+  int chunkSize = std::max(int(source.size()/size_t(4*numThreads)), minChunkSize);
 
-      if (! isCompleteLine1('}'))
-        return false;
+  Chunks chunks;
 
-      if (! parse_->isChar('}'))
-        return false;
+  splitChunks(source.view(), chunkSize, chunks);
 
-      parse_->skipChar();
-    }
-    else if (parse_->isChar(endChar)) {
-      return true;
-    }
-    else if (parse_->isChar('\"')) {
-      parse_->skipChar();
+  int numChunks = int(chunks.size());
 
-      if (! isCompleteLine1('\"'))
-        return false;
+  if (numChunks < 2)
+    return false;
 
-      if (! parse_->isChar('\"'))
-        return false;
+  arena_.setSource(std::move(source));
 
-      parse_->skipChar();
+  //---
+
+  // parse chunks on threads (each chunk parser has own arena for tokens)
+  using ParseP = std::unique_ptr<CTclParse>;
+
+  std::vector<ParseP> chunkParses(numChunks);
+  std::vector<Tokens> chunkTokens(numChunks);
+  std::vector<char>   chunkRc    (numChunks, 0);
+
+  std::atomic<int> nextChunk { 0 };
+
+  auto worker = [&]() {
+    int i;
+
+    while ((i = nextChunk++) < numChunks) {
+      chunkParses[i] = std::make_unique<CTclParse>();
+
+      chunkRc[i] = chunkParses[i]->parseChunk(arena_, chunks[i], chunkTokens[i]);
     }
-    else if (parse_->isChar('\'')) {
-      parse_->skipChar();
+  };
 
-      if (! isCompleteLine1('\''))
-        return false;
+  numThreads = std::min(numThreads, numChunks);
 
-      if (! parse_->isChar('\''))
-        return false;
+  std::vector<std::thread> threads;
 
-      parse_->skipChar();
+  for (int i = 1; i < numThreads; ++i)
+    threads.emplace_back(worker);
+
+  worker();
+
+  for (auto &thread : threads)
+    thread.join();
+
+  // chunk failure (split inside command) is reparsed serially
+  for (int i = 0; i < numChunks; ++i) {
+    if (! chunkRc[i])
+      return false;
+  }
+
+  //---
+
+  // stitch chunk tokens (positions and line numbers are already file based)
+  for (int i = 0; i < numChunks; ++i) {
+    arena_.adopt(chunkParses[i]->arena_);
+
+    for (auto *token : chunkTokens[i])
+      tokens.push_back(token);
+  }
+
+  return true;
+}
+
+void
+CTclParse::
+splitChunks(std::string_view text, int minSize, Chunks &chunks)
+{
+  // split at top level newlines using the parser's quoting rules:
+  //  . quotes only start a string at the start of a word
+  //  . braces are literal in double quotes (except for ${name})
+  //  . quoted text in braces is skipped to the closing quote
+  // (a split inside a command is detected by the chunk parse which then fails)
+  int n = int(text.size());
+
+  Chunk chunk;
+
+  int lineNum = 1;
+
+  // end chars of nested contexts (']' command, '}' braces, quote char for strings,
+  // 'q' double quoted text in braces)
+  std::string endChars;
+
+  auto isWordStart = [&](int i) {
+    if (i == 0) return true;
+
+    char c = text[i - 1];
+
+    return (isspace(c) || c == ';' || c == '[');
+  };
+
+  auto isVarBrace = [&](int i) { return (i > 0 && text[i - 1] == '$'); };
+
+  int i = 0;
+
+  while (i < n) {
+    i = int(CTclScan::findNext(text.data(), size_t(i), size_t(n)));
+
+    if (i >= n)
+      break;
+
+    char c   = text[i];
+    char end = (! endChars.empty() ? endChars.back() : '\0');
+
+    if      (c == '\n') {
+      ++lineNum;
+
+      if (end == '\0' && i + 1 - chunk.start >= minSize) {
+        chunk.end = i + 1;
+
+        chunks.push_back(chunk);
+
+        chunk.start   = i + 1;
+        chunk.lineNum = lineNum;
+      }
     }
-    else if (parse_->isChar('\\')) {
-      parse_->skipChar();
-      parse_->skipChar();
+    else if (c == '\\') {
+      // escaped newline (continuation) is not a split point but is a new line
+      if (end != '\'' && i + 1 < n) {
+        if (text[i + 1] == '\n')
+          ++lineNum;
+
+        ++i;
+      }
     }
-    else
-      parse_->skipChar();
+    else if (end == '\0' || end == ']') {
+      // command
+      if      (c == '[')
+        endChars.push_back(']');
+      else if (c == ']') {
+        if (end == ']')
+          endChars.pop_back();
+      }
+      else if (c == '{') {
+        if (isWordStart(i) || isVarBrace(i))
+          endChars.push_back('}');
+      }
+      else if (c == '\"' || c == '\'') {
+        if (isWordStart(i))
+          endChars.push_back(c);
+      }
+    }
+    else if (end == '\"') {
+      if      (c == '\"')
+        endChars.pop_back();
+      else if (c == '[')
+        endChars.push_back(']');
+      else if (c == '{' && isVarBrace(i))
+        endChars.push_back('}');
+    }
+    else if (end == '}') {
+      if      (c == '{')
+        endChars.push_back('}');
+      else if (c == '}')
+        endChars.pop_back();
+      else if (c == '\"')
+        endChars.push_back('q');
+    }
+    else if (end == 'q') {
+      if (c == '\"')
+        endChars.pop_back();
+    }
+    else if (end == '\'') {
+      if (c == '\'')
+        endChars.pop_back();
+    }
+
+    ++i;
   }
 
-  return true;
+  if (chunk.start < n) {
+    chunk.end = n;
+
+    chunks.push_back(chunk);
+  }
 }
 
 bool
 CTclParse::
-parseFile(const std::string &filename, Tokens &tokens)
+parseChunk(const CTclTokenArena &arena, const Chunk &chunk, Tokens &tokens)
 {
-  if (! CFile::isRegular(filename)) {
-    std::cerr << "Invalid file " << filename << "\n";
-    return false;
-  }
+  // tokens reference text of file parse arena
+  arena_.shareSource(arena);
 
-#ifdef DEBUG_LINES
-  CFile::toLines(filename, fileLines_);
-#endif
+  auto text = arena.source();
 
-  startFileParse(filename);
+  parseStack_.push_back(parse_);
+
+  parse_ = new CTclScanner;
+
+  parse_->setJoinLines(true);
+
+  parse_->setRange(text.data(), chunk.start, chunk.end, chunk.lineNum);
+
+  // failure is reparsed serially (which reports errors). Chunk must end at a top
+  // level command boundary so end inside a string or command (split inside command)
+  // is a failure, except for the last chunk which ends at end of file
+  quiet_     = true;
+  strictEnd_ = (chunk.end < int(text.size()));
 
   bool rc = true;
 
+  Tokens tokens1;
+
   while (! parse_->eof()) {
-    Tokens tokens1;
+    tokens1.clear();
 
     try {
       if (! readArgList(tokens1)) {
@@ -142,6 +334,7 @@ parseFile(const std::string &filename, Tokens &tokens)
         tokens.push_back(token1);
     }
     catch (...) {
+      rc = false;
       break;
     }
   }
@@ -162,12 +355,19 @@ bool
 CTclParse::
 parseString(const std::string &str, Tokens &tokens)
 {
+  // release tokens of previous parse
+  index_.clear();
+
+  arena_.clear();
+
   startStringParse(str);
 
   bool rc = true;
 
+  Tokens tokens1;
+
   while (! parse_->eof()) {
-    Tokens tokens1;
+    tokens1.clear();
 
     if (! readArgList(tokens1)) {
       rc = false;
@@ -178,6 +378,11 @@ parseString(const std::string &str, Tokens &tokens)
       tokens.push_back(token1);
   }
 
+  // token spans reference parsed text
+  arena_.setSource(parse_->takeSource());
+
+  index_.build(tokens);
+
   endParse();
 
   return rc;
@@ -190,7 +395,8 @@ readArgList(Tokens &tokens)
   bool isComment = false;
 
   while (! parse_->eof()) {
-    while (parse_->isChar(' ') || parse_->isChar('\t'))
+    // skip blanks (any space except newline, e.g. '\r' or '\f')
+    while (parse_->isSpace() && ! parse_->isChar('\n'))
       parse_->skipChar();
 
     if (parse_->eof())
@@ -206,9 +412,7 @@ readArgList(Tokens &tokens)
 
       parse_->skipChar();
 
-      auto *token = createToken(CTclToken::Type::SEPARATOR, ";", parseData);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::SEPARATOR, parseData));
 
       return true;
     }
@@ -220,17 +424,10 @@ readArgList(Tokens &tokens)
       if (! readExecString(tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::SUB_COMMAND, str, parseData);
-
       if (tokens1.size() > 0)
         tokens1[0]->setType(CTclToken::Type::COMMAND);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::SUB_COMMAND, parseData, tokens1));
     }
     else if (parse_->isChar(']')) {
       //return true;
@@ -245,14 +442,9 @@ readArgList(Tokens &tokens)
       if (! readLiteralString(str, tokens1))
         return false;
 
-      auto str1 = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::LITERAL_STRING, str1, parseData);
+      auto *token = createToken(CTclToken::Type::LITERAL_STRING, parseData, tokens1);
 
-      token->setAltStr(str);
-
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
+      setAltStr(token, str, '}');
 
       tokens.push_back(token);
     }
@@ -265,14 +457,9 @@ readArgList(Tokens &tokens)
       if (! readDoubleQuotedString(str, tokens1))
         return false;
 
-      auto str1 = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::QUOTED_STRING, str1, parseData);
-
-      token->setAltStr(str);
+      auto *token = createToken(CTclToken::Type::QUOTED_STRING, parseData, tokens1);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
+      setAltStr(token, str, '\"');
 
       tokens.push_back(token);
     }
@@ -284,7 +471,11 @@ readArgList(Tokens &tokens)
       if (! readSingleQuotedString(str))
         return false;
 
-      tokens.push_back(createToken(CTclToken::Type::QUOTED_STRING, str, parseData));
+      auto *token = createToken(CTclToken::Type::QUOTED_STRING, parseData);
+
+      setAltStr(token, str, '\'');
+
+      tokens.push_back(token);
     }
     else if (parse_->isChar('$')) {
       auto parseData = getParseData();
@@ -299,38 +490,19 @@ readArgList(Tokens &tokens)
       if (! readVariableName(varName, is_array, tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::VARIABLE, str, parseData);
-
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      if (! parse_->isSpace()) {
-        int pos1 = parse_->getPos();
+      auto *token = createToken(CTclToken::Type::VARIABLE, parseData, tokens1);
 
+      // variable followed by text is string with variable as first sub token
+      if (! parse_->eof() && ! parse_->isSpace()) {
         std::string str1;
         Tokens      tokens11;
 
         if (! readWord(str1, ';', tokens11))
           return false;
 
-        str1 = parse_->getBefore(pos1);
-
-        if (tokens1.empty()) {
-          delete token;
+        tokens11.insert(tokens11.begin(), token);
 
-          str1 = str + str1;
-        }
-        else
-          tokens.push_back(token);
-
-        auto *token1 = createToken(CTclToken::Type::STRING, str1, parseData);
-
-        for (const auto &token2 : tokens11)
-          token->addToken(token2);
-
-        tokens.push_back(token1);
+        tokens.push_back(createToken(CTclToken::Type::STRING, parseData, tokens11));
       }
       else
         tokens.push_back(token);
@@ -346,9 +518,7 @@ readArgList(Tokens &tokens)
       if (! readWord(str, endChar, tokens1))
         return false;
 
-      str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::STRING, str, parseData);
+      auto *token = createToken(CTclToken::Type::STRING, parseData, tokens1);
 
       if (tokens.empty()) {
         token->setType(CTclToken::Type::COMMAND);
@@ -356,9 +526,6 @@ readArgList(Tokens &tokens)
         isComment = (str == "#");
       }
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
       tokens.push_back(token);
     }
   }
@@ -386,12 +553,9 @@ readExecString(Tokens &tokens)
       if (! readLiteralString(str1, tokens1))
         return false;
 
-      str1 = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::LITERAL_STRING, str1, parseData);
+      auto *token = createToken(CTclToken::Type::LITERAL_STRING, parseData, tokens1);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
+      setAltStr(token, str1, '}');
 
       tokens.push_back(token);
     }
@@ -404,12 +568,9 @@ readExecString(Tokens &tokens)
       if (! readDoubleQuotedString(str1, tokens1))
         return false;
 
-      str1 = parse_->getBefore(parseData.pos);
+      auto *token = createToken(CTclToken::Type::QUOTED_STRING, parseData, tokens1);
 
-      auto *token = createToken(CTclToken::Type::QUOTED_STRING, str1, parseData);
-
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
+      setAltStr(token, str1, '\"');
 
       tokens.push_back(token);
     }
@@ -421,7 +582,11 @@ readExecString(Tokens &tokens)
       if (! readSingleQuotedString(str1))
         return false;
 
-      tokens.push_back(createToken(CTclToken::Type::QUOTED_STRING, str1, parseData));
+      auto *token = createToken(CTclToken::Type::QUOTED_STRING, parseData);
+
+      setAltStr(token, str1, '\'');
+
+      tokens.push_back(token);
     }
     else if (parse_->isChar('[')) {
       auto parseData = getParseData();
@@ -431,17 +596,10 @@ readExecString(Tokens &tokens)
       if (! readExecString(tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::SUB_COMMAND, str, parseData);
-
       if (tokens1.size() > 0)
         tokens1[0]->setType(CTclToken::Type::COMMAND);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::SUB_COMMAND, parseData, tokens1));
     }
     else {
       auto parseData = getParseData();
@@ -452,16 +610,11 @@ readExecString(Tokens &tokens)
       if (! readWord(str, ']', tokens1))
         return false;
 
-      str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::STRING, str, parseData);
+      auto *token = createToken(CTclToken::Type::STRING, parseData, tokens1);
 
       if (tokens.empty())
         token->setType(CTclToken::Type::COMMAND);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
       tokens.push_back(token);
     }
 
@@ -470,6 +623,8 @@ readExecString(Tokens &tokens)
 
   if (! parse_->eof())
     parse_->skipChar();
+  else if (strictEnd_)
+    return false;
 
   return true;
 }
@@ -557,6 +712,14 @@ readLiteralString(std::string &str, Tokens &)
     }
 #endif
     else {
+      // copy run of non structural chars
+      auto run = parse_->readPlain();
+
+      if (! run.empty()) {
+        str.append(run.data(), run.size());
+        continue;
+      }
+
       char c;
 
       if (! parse_->readChar(&c)) {
@@ -612,17 +775,10 @@ readDoubleQuotedString(std::string &str, Tokens &tokens)
       if (! readExecString(tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::SUB_COMMAND, str, parseData);
-
       if (tokens1.size() > 0)
         tokens1[0]->setType(CTclToken::Type::COMMAND);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::SUB_COMMAND, parseData, tokens1));
     }
     else if (parse_->isChar('$')) {
       auto parseData = getParseData();
@@ -636,14 +792,7 @@ readDoubleQuotedString(std::string &str, Tokens &tokens)
       if (! readVariableName(varName, is_array, tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::VARIABLE, str, parseData);
-
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::VARIABLE, parseData, tokens1));
     }
     else if (parse_->isChar('\\')) {
       parse_->skipChar();
@@ -728,6 +877,14 @@ readDoubleQuotedString(std::string &str, Tokens &tokens)
       }
     }
     else {
+      // copy run of non structural chars
+      auto run = parse_->readPlain();
+
+      if (! run.empty()) {
+        str.append(run.data(), run.size());
+        continue;
+      }
+
       char c;
 
       if (! parse_->readChar(&c)) {
@@ -741,6 +898,8 @@ readDoubleQuotedString(std::string &str, Tokens &tokens)
 
   if (! parse_->eof())
     parse_->skipChar();
+  else if (strictEnd_)
+    return false;
 
   return true;
 }
@@ -768,6 +927,8 @@ readSingleQuotedString(std::string &str)
 
   if (! parse_->eof())
     parse_->skipChar();
+  else if (strictEnd_)
+    return false;
 
   return true;
 }
@@ -863,17 +1024,10 @@ readWord(std::string &str, char endChar, Tokens &tokens)
       if (! readExecString(tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::SUB_COMMAND, str, parseData);
-
       if (tokens1.size() > 0)
         tokens1[0]->setType(CTclToken::Type::COMMAND);
 
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::SUB_COMMAND, parseData, tokens1));
     }
     else if (parse_->isChar('$')) {
       auto parseData = getParseData();
@@ -887,14 +1041,7 @@ readWord(std::string &str, char endChar, Tokens &tokens)
       if (! readVariableName(varName, is_array, tokens1))
         return false;
 
-      auto str = parse_->getBefore(parseData.pos);
-
-      auto *token = createToken(CTclToken::Type::VARIABLE, str, parseData);
-
-      for (const auto &token1 : tokens1)
-        token->addToken(token1);
-
-      tokens.push_back(token);
+      tokens.push_back(createToken(CTclToken::Type::VARIABLE, parseData, tokens1));
     }
     else if (parse_->isChar('\\')) {
       parse_->skipChar();
@@ -938,18 +1085,21 @@ getParseData() const
 
 CTclToken *
 CTclParse::
-createToken(CTclToken::Type type, const std::string &str, const ParseData &parseData) const
+createToken(CTclToken::Type type, const ParseData &parseData, const Tokens &tokens)
 {
+  // token is source span from start position to current position
+  int len = parse_->getPos() - parseData.pos;
+
 #ifdef DEBUG_LINES
   if (! fileLines_.empty()) {
-    auto str1 = str;
+    auto str1 = std::string(parse_->text().substr(parseData.pos, len));
 
     auto p = str1.find('\n');
 
     if (p != std::string::npos)
       str1 = str1.substr(0, p);
 
-    int len = str1.size();
+    int len1 = str1.size();
 
     assert(parseData.lineNum >= 1 && parseData.lineNum <= int(fileLines_.size()));
 
@@ -957,26 +1107,53 @@ createToken(CTclToken::Type type, const std::string &str, const ParseData &parse
 
     assert(parseData.linePos >= 0 && parseData.linePos < int(line.size()));
 
-    auto str2 = line.substr(parseData.linePos, len);
+    auto str2 = line.substr(parseData.linePos, len1);
 
     assert(str1 == str2);
   }
 #endif
 
-  auto *token = new CTclToken(type, str, parseData.lineNum, parseData.linePos);
+  auto *token = arena_.createToken(type, parseData.pos, len, parseData.lineNum, parseData.linePos);
 
-  token->setPos(parseData.pos);
+  if (! tokens.empty())
+    token->setTokens(arena_.createTokens(tokens));
 
   return token;
 }
 
+void
+CTclParse::
+setAltStr(CTclToken *token, const std::string &str, char endChar)
+{
+  // text inside quotes/braces (end char missing if unterminated)
+  auto src = parse_->text();
+
+  int pos = token->pos() + 1;
+  int len = token->len() - 1;
+
+  if (len > 0 && src[token->endPos()] == endChar)
+    --len;
+
+  // only copy text if changed by escapes
+  if (len == int(str.size()) && src.compare(pos, len, str) == 0)
+    token->setAltSpan(pos, len);
+  else
+    token->setAltStr(arena_.createString(str), int(str.size()));
+}
+
 void
 CTclParse::
 startFileParse(const std::string &fileName)
 {
   parseStack_.push_back(parse_);
 
-  parse_ = new CTclStrParse(this, fileName);
+  // file is parsed in place (continuation lines are joined by scanner)
+  parse_ = new CTclScanner;
+
+  parse_->setJoinLines(true);
+
+  if (! parse_->mapFile(fileName))
+    std::cerr << "Failed to read " << fileName << "\n";
 }
 
 void
@@ -985,7 +1162,9 @@ startStringParse(const std::string &str)
 {
   parseStack_.push_back(parse_);
 
-  parse_ = new CStrParse(str);
+  parse_ = new CTclScanner;
+
+  parse_->setString(str);
 }
 
 void
@@ -1003,9 +1182,20 @@ CTclToken *
 CTclParse::
 getTokenForPos(const Tokens &tokens, int pos) const
 {
-  for (const auto &token : tokens) {
+  return getTokenForPos(tokens.data(), tokens.data() + tokens.size(), pos);
+}
+
+CTclToken *
+CTclParse::
+getTokenForPos(CTclToken *const *begin, CTclToken *const *end, int pos)
+{
+  for (auto *p = begin; p != end; ++p) {
+    auto *token = *p;
+
     if (token->hasPos(pos)) {
-      auto *token1 = getTokenForPos(token->tokens(), pos);
+      const auto &tokens1 = token->tokens();
+
+      auto *token1 = getTokenForPos(tokens1.begin(), tokens1.end(), pos);
 
       if (token1)
         return token1;
@@ -1039,6 +1229,9 @@ void
 CTclParse::
 syntaxError(const std::string &msg, int initPos)
 {
+  if (quiet_)
+    return;
+
   std::cerr << "Error: " << msg << "\n  ";
 
   //std::cerr << parse_->stateStr() << "\n";
@@ -1047,76 +1240,209 @@ syntaxError(const std::string &msg, int initPos)
 
 //--------------
 
-CTclStrParse::
-CTclStrParse(CTclParse *tcl, const std::string &filename) :
- tcl_(tcl)
+void
+CTclTokenIndex::
+build(const Tokens &tokens)
 {
-  file_ = new CFile(filename);
+  segments_.clear();
+
+  int pos = std::numeric_limits<int>::min();
+
+  for (auto *token : tokens)
+    addToken(token, std::numeric_limits<int>::max(), pos);
 }
 
-CTclStrParse::
-~CTclStrParse()
+void
+CTclTokenIndex::
+addToken(CTclToken *token, int end, int &pos)
 {
-  delete file_;
+  // token range clipped to parent and previous tokens (first token wins on overlap)
+  int s = std::max(token->pos(), pos);
+  int e = std::min(token->pos() + token->len(), end);
+
+  if (s >= e)
+    return;
+
+  pos = s;
+
+  // parent owns gaps between children
+  for (auto *child : token->tokens()) {
+    int cs = std::min(std::max(child->pos(), pos), e);
+
+    if (cs > pos) {
+      addSegment(pos, cs, token);
+
+      pos = cs;
+    }
+
+    addToken(child, e, pos);
+  }
+
+  if (pos < e) {
+    addSegment(pos, e, token);
+
+    pos = e;
+  }
 }
 
-bool
-CTclStrParse::
-fillBuffer()
+void
+CTclTokenIndex::
+addSegment(int start, int end, CTclToken *token)
 {
-  std::string line;
+  if (! segments_.empty()) {
+    auto &segment = segments_.back();
 
-  if (! file_->readLine(line))
-    return false;
+    if (segment.token == token && segment.end == start) {
+      segment.end = end;
+      return;
+    }
+  }
 
-  ++lineNum_;
+  Segment segment;
 
-  uint len = line.size();
+  segment.start = start;
+  segment.end   = end;
+  segment.token = token;
 
-  while (len > 0 && line[len - 1] == '\\') {
-    line = line.substr(0, len - 1);
+  segments_.push_back(segment);
+}
 
-    std::string line1;
+int
+CTclTokenIndex::
+findIndex(int pos) const
+{
+  int i = prevIndex(pos + 1);
 
-    if (file_->readLine(line1)) {
-      ++lineNum_;
+  if (i >= 0 && pos < segments_[i].end)
+    return i;
 
-      uint len1 = line1.size();
+  return -1;
+}
 
-      uint i = 0;
+int
+CTclTokenIndex::
+prevIndex(int pos) const
+{
+  auto p = std::lower_bound(segments_.begin(), segments_.end(), pos,
+    [](const Segment &segment, int pos) { return segment.start < pos; });
 
-      while (i < len1 && isspace(line1[i]))
-        ++i;
+  return int(p - segments_.begin()) - 1;
+}
 
-      line += " " + line1.substr(0);
-    }
+int
+CTclTokenIndex::
+nextIndex(int pos) const
+{
+  auto p = std::upper_bound(segments_.begin(), segments_.end(), pos,
+    [](int pos, const Segment &segment) { return pos < segment.end; });
 
-    len = line.size();
-  }
+  return int(p - segments_.begin());
+}
 
-  if (getPos() > 0)
-    addString("\n" + line);
-  else
-    addString(line);
+//--------------
 
-  //std::cerr << "===\n" << getString() << "\n===\n";
+static_assert(std::is_trivially_destructible<CTclToken>::value,
+              "arena tokens must be trivially destructible");
 
-  return true;
+CTclTokenArena::
+~CTclTokenArena()
+{
+  clear();
 }
 
-bool
-CTclStrParse::
-eof() const
+CTclToken *
+CTclTokenArena::
+createToken(CTclToken::Type type, int pos, int len, int lineNum, int linePos)
 {
-  if (! CStrParse::eof())
-    return false;
+  auto *mem = alloc(sizeof(CTclToken), alignof(CTclToken));
 
-  auto *th = const_cast<CTclStrParse *>(this);
+  ++numTokens_;
 
-  th->fillBuffer();
+  return new (mem) CTclToken(type, srcView_, pos, len, lineNum, linePos);
+}
 
-  if (! CStrParse::eof())
-    return false;
+CTclToken::TokenArray
+CTclTokenArena::
+createTokens(const Tokens &tokens)
+{
+  int n = int(tokens.size());
+
+  auto *mem = alloc(n*sizeof(CTclToken *), alignof(CTclToken *));
+
+  auto **tokens1 = static_cast<CTclToken **>(mem);
+
+  std::copy(tokens.begin(), tokens.end(), tokens1);
+
+  return CTclToken::TokenArray(tokens1, n);
+}
+
+const char *
+CTclTokenArena::
+createString(const std::string &str)
+{
+  auto *mem = static_cast<char *>(alloc(str.size() + 1, 1));
+
+  memcpy(mem, str.c_str(), str.size() + 1);
+
+  return mem;
+}
+
+void
+CTclTokenArena::
+adopt(CTclTokenArena &arena)
+{
+  // adopted blocks are added before current block so it is still used for allocation
+  blocks_.insert(blocks_.begin(), arena.blocks_.begin(), arena.blocks_.end());
+
+  numTokens_ += arena.numTokens_;
+
+  arena.blocks_.clear();
+
+  arena.numTokens_ = 0;
+}
+
+void
+CTclTokenArena::
+clear()
+{
+  // tokens are trivially destructible so blocks are just freed
+  for (auto &block : blocks_)
+    delete [] block.data;
+
+  blocks_.clear();
+
+  source_.clear();
+
+  sourceView_ = std::string_view();
+  srcView_    = &sourceView_;
+
+  numTokens_ = 0;
+}
+
+void *
+CTclTokenArena::
+alloc(size_t size, size_t align)
+{
+  if (! blocks_.empty()) {
+    auto &block = blocks_.back();
+
+    size_t pos = (block.used + align - 1) & ~(align - 1);
+
+    if (pos + size <= block.size) {
+      block.used = pos + size;
+
+      return block.data + pos;
+    }
+  }
+
+  // new block (large requests get own block)
+  Block block;
+
+  block.size = std::max(size, blockSize);
+  block.data = new char [block.size];
+  block.used = size;
+
+  blocks_.push_back(block);
 
-  return file_->eof();
+  return block.data;
 }
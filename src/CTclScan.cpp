@@ -0,0 +1,250 @@
+#include <CTclScan.h>
+#include <string>
+#include <cstdint>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <immintrin.h>
+#define CTCL_SCAN_X86 1
+#endif
+
+namespace CTclScan {
+
+namespace {
+
+// structural char lookup (bit 1 nesting, bit 2 separator)
+struct CharTable {
+  CharTable() {
+    for (const char *p = "[]{}\"'\\"; *p; ++p)
+      flags[uint8_t(*p)] = 1;
+
+    for (const char *p = "\n;$"; *p; ++p)
+      flags[uint8_t(*p)] = 2;
+  }
+
+  bool isStructural(char c, Chars chars) const {
+    uint8_t f = flags[uint8_t(c)];
+
+    return (chars == Chars::ALL ? f != 0 : f == 1);
+  }
+
+  uint8_t flags[256] { };
+};
+
+const CharTable &charTable()
+{
+  static CharTable table;
+
+  return table;
+}
+
+//---
+
+size_t findNextScalar(const char *data, size_t pos, size_t len, Chars chars)
+{
+  const auto &table = charTable();
+
+  while (pos < len && ! table.isStructural(data[pos], chars))
+    ++pos;
+
+  return pos;
+}
+
+#ifdef CTCL_SCAN_X86
+// bit mask of structural chars in 16 bytes
+inline uint32_t structuralMask16(const char *p, Chars chars)
+{
+  auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+  auto eq = [&](char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+
+  auto m = _mm_or_si128(_mm_or_si128(eq('['), eq(']')), _mm_or_si128(eq('{'), eq('}')));
+
+  m = _mm_or_si128(m, _mm_or_si128(_mm_or_si128(eq('\"'), eq('\'')), eq('\\')));
+
+  if (chars == Chars::ALL)
+    m = _mm_or_si128(m, _mm_or_si128(_mm_or_si128(eq('\n'), eq(';')), eq('$')));
+
+  return uint32_t(_mm_movemask_epi8(m));
+}
+
+size_t findNextSSE2(const char *data, size_t pos, size_t len, Chars chars)
+{
+  while (pos + 16 <= len) {
+    auto mask = structuralMask16(data + pos, chars);
+
+    if (mask)
+      return pos + size_t(__builtin_ctz(mask));
+
+    pos += 16;
+  }
+
+  return findNextScalar(data, pos, len, chars);
+}
+
+void findAllSSE2(const char *data, size_t len, Positions &positions, Chars chars)
+{
+  size_t pos = 0;
+
+  for ( ; pos + 16 <= len; pos += 16) {
+    auto mask = structuralMask16(data + pos, chars);
+
+    while (mask) {
+      positions.push_back(int(pos) + __builtin_ctz(mask));
+
+      mask &= mask - 1;
+    }
+  }
+
+  for ( ; pos < len; ++pos)
+    if (charTable().isStructural(data[pos], chars))
+      positions.push_back(int(pos));
+}
+
+//---
+
+// bit mask of structural chars in 32 bytes
+__attribute__((target("avx2")))
+inline uint32_t structuralMask32(const char *p, Chars chars)
+{
+  // (no lambda as it would not be compiled for avx2 target)
+  auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+#define CTCL_SCAN_EQ32(c) _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))
+
+  auto m = _mm256_or_si256(_mm256_or_si256(CTCL_SCAN_EQ32('['), CTCL_SCAN_EQ32(']')),
+                           _mm256_or_si256(CTCL_SCAN_EQ32('{'), CTCL_SCAN_EQ32('}')));
+
+  m = _mm256_or_si256(m, _mm256_or_si256(_mm256_or_si256(CTCL_SCAN_EQ32('\"'),
+                                                         CTCL_SCAN_EQ32('\'')),
+                                         CTCL_SCAN_EQ32('\\')));
+
+  if (chars == Chars::ALL)
+    m = _mm256_or_si256(m, _mm256_or_si256(_mm256_or_si256(CTCL_SCAN_EQ32('\n'),
+                                                           CTCL_SCAN_EQ32(';')),
+                                           CTCL_SCAN_EQ32('$')));
+
+#undef CTCL_SCAN_EQ32
+
+  return uint32_t(_mm256_movemask_epi8(m));
+}
+
+__attribute__((target("avx2")))
+size_t findNextAVX2(const char *data, size_t pos, size_t len, Chars chars)
+{
+  while (pos + 32 <= len) {
+    auto mask = structuralMask32(data + pos, chars);
+
+    if (mask)
+      return pos + size_t(__builtin_ctz(mask));
+
+    pos += 32;
+  }
+
+  return findNextSSE2(data, pos, len, chars);
+}
+
+__attribute__((target("avx2")))
+void findAllAVX2(const char *data, size_t len, Positions &positions, Chars chars)
+{
+  size_t pos = 0;
+
+  for ( ; pos + 32 <= len; pos += 32) {
+    auto mask = structuralMask32(data + pos, chars);
+
+    while (mask) {
+      positions.push_back(int(pos) + __builtin_ctz(mask));
+
+      mask &= mask - 1;
+    }
+  }
+
+  for ( ; pos < len; ++pos)
+    if (charTable().isStructural(data[pos], chars))
+      positions.push_back(int(pos));
+}
+
+bool hasAVX2()
+{
+  static bool avx2 = __builtin_cpu_supports("avx2");
+
+  return avx2;
+}
+#endif
+
+}
+
+//---
+
+size_t
+findNext(const char *data, size_t pos, size_t len, Chars chars)
+{
+#ifdef CTCL_SCAN_X86
+  if (hasAVX2())
+    return findNextAVX2(data, pos, len, chars);
+
+  return findNextSSE2(data, pos, len, chars);
+#else
+  return findNextScalar(data, pos, len, chars);
+#endif
+}
+
+void
+findAll(const char *data, size_t len, Positions &positions, Chars chars)
+{
+#ifdef CTCL_SCAN_X86
+  if (hasAVX2())
+    return findAllAVX2(data, len, positions, chars);
+
+  return findAllSSE2(data, len, positions, chars);
+#else
+  for (size_t pos = 0; pos < len; ++pos)
+    if (charTable().isStructural(data[pos], chars))
+      positions.push_back(int(pos));
+#endif
+}
+
+bool
+isComplete(const char *data, size_t len)
+{
+  Positions positions;
+
+  findAll(data, len, positions, Chars::NESTING);
+
+  // stack of expected closing chars
+  std::string endChars;
+
+  size_t n = positions.size();
+
+  for (size_t k = 0; k < n; ++k) {
+    int  i = positions[k];
+    char c = data[i];
+
+    if      (c == '[')
+      endChars.push_back(']');
+    else if (c == '{')
+      endChars.push_back('}');
+    else if (! endChars.empty() && c == endChars.back())
+      endChars.pop_back();
+    else if (c == '\"' || c == '\'')
+      endChars.push_back(c);
+    else if (c == '\\') {
+      // escaped char is skipped (only matters if structural)
+      if (k + 1 < n && positions[k + 1] == i + 1)
+        ++k;
+    }
+  }
+
+  return endChars.empty();
+}
+
+const char *
+simdName()
+{
+#ifdef CTCL_SCAN_X86
+  return (hasAVX2() ? "avx2" : "sse2");
+#else
+  return "scalar";
+#endif
+}
+
+}
@@ -0,0 +1,297 @@
+#include <CTclScanner.h>
+#include <CTclScan.h>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+CTclSource::
+~CTclSource()
+{
+  clear();
+}
+
+CTclSource::
+CTclSource(CTclSource &&source)
+{
+  *this = std::move(source);
+}
+
+CTclSource &
+CTclSource::
+operator=(CTclSource &&source)
+{
+  if (this == &source)
+    return *this;
+
+  clear();
+
+  if (source.map_) {
+    map_  = source.map_;
+    data_ = source.data_;
+    size_ = source.size_;
+  }
+  else {
+    str_  = std::move(source.str_);
+    data_ = str_.c_str();
+    size_ = str_.size();
+  }
+
+  source.map_  = nullptr;
+  source.data_ = "";
+  source.size_ = 0;
+
+  source.str_.clear();
+
+  return *this;
+}
+
+void
+CTclSource::
+setString(const std::string &str)
+{
+  clear();
+
+  str_  = str;
+  data_ = str_.c_str();
+  size_ = str_.size();
+}
+
+bool
+CTclSource::
+mapFile(const std::string &filename)
+{
+  clear();
+
+  int fd = open(filename.c_str(), O_RDONLY);
+
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    auto *map = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (map != MAP_FAILED) {
+      // whole file is scanned sequentially
+      (void) madvise(map, size_t(st.st_size), MADV_SEQUENTIAL);
+
+      map_  = map;
+      data_ = static_cast<const char *>(map);
+      size_ = size_t(st.st_size);
+    }
+  }
+
+  close(fd);
+
+  if (map_)
+    return true;
+
+  // empty or unmappable file
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+
+  if (! is)
+    return false;
+
+  std::ostringstream os;
+
+  os << is.rdbuf();
+
+  setString(os.str());
+
+  return true;
+}
+
+void
+CTclSource::
+clear()
+{
+  if (map_)
+    munmap(map_, size_);
+
+  map_ = nullptr;
+
+  str_.clear();
+
+  data_ = "";
+  size_ = 0;
+}
+
+//---
+
+CTclScanner::
+CTclScanner()
+{
+}
+
+void
+CTclScanner::
+setString(const std::string &str)
+{
+  source_.setString(str);
+
+  init();
+}
+
+bool
+CTclScanner::
+mapFile(const std::string &filename)
+{
+  bool rc = source_.mapFile(filename);
+
+  init();
+
+  return rc;
+}
+
+void
+CTclScanner::
+setRange(const char *data, int start, int end, int lineNum)
+{
+  source_.clear();
+
+  data_ = data;
+  len_  = end;
+
+  pos_     = start;
+  lineNum_ = lineNum;
+  linePos_ = 0;
+
+  prev_ = State();
+}
+
+CTclSource
+CTclScanner::
+takeSource()
+{
+  CTclSource source(std::move(source_));
+
+  init();
+
+  return source;
+}
+
+void
+CTclScanner::
+init()
+{
+  data_ = source_.data();
+  len_  = int(source_.size());
+
+  pos_     = 0;
+  lineNum_ = 1;
+  linePos_ = 0;
+
+  prev_ = State();
+}
+
+void
+CTclScanner::
+skipChar()
+{
+  if (pos_ >= len_)
+    return;
+
+  prev_.pos     = pos_;
+  prev_.lineNum = lineNum_;
+  prev_.linePos = linePos_;
+
+  if      (joinLines_ && isContinuation(pos_)) {
+    // skip backslash, newline and leading blanks of next line
+    pos_ += 2;
+
+    ++lineNum_;
+
+    linePos_ = 0;
+
+    while (pos_ < len_ && (data_[pos_] == ' ' || data_[pos_] == '\t')) {
+      ++pos_;
+      ++linePos_;
+    }
+  }
+  else if (data_[pos_] == '\n') {
+    ++pos_;
+
+    ++lineNum_;
+
+    linePos_ = 0;
+  }
+  else {
+    ++pos_;
+    ++linePos_;
+  }
+}
+
+void
+CTclScanner::
+skipSpace()
+{
+  while (isSpace())
+    skipChar();
+}
+
+bool
+CTclScanner::
+readChar(char *c)
+{
+  if (eof())
+    return false;
+
+  *c = getCharAt();
+
+  skipChar();
+
+  return true;
+}
+
+void
+CTclScanner::
+unreadChar()
+{
+  pos_     = prev_.pos;
+  lineNum_ = prev_.lineNum;
+  linePos_ = prev_.linePos;
+}
+
+std::string_view
+CTclScanner::
+readPlain()
+{
+  // run has no newline or backslash so line and continuation state is simple
+  int pos = int(CTclScan::findNext(data_, size_t(pos_), size_t(len_)));
+
+  std::string_view run(data_ + pos_, size_t(pos - pos_));
+
+  if (pos > pos_) {
+    prev_.pos     = pos - 1;
+    prev_.lineNum = lineNum_;
+    prev_.linePos = linePos_ + (pos - pos_ - 1);
+
+    linePos_ += pos - pos_;
+    pos_      = pos;
+  }
+
+  return run;
+}
+
+std::string
+CTclScanner::
+getBefore(int pos) const
+{
+  if (pos < 0 || pos > pos_)
+    return "";
+
+  return std::string(data_ + pos, size_t(pos_ - pos));
+}
+
+std::string
+CTclScanner::
+getAfter() const
+{
+  return std::string(data_ + pos_, size_t(len_ - pos_));
+}
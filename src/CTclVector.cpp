@@ -0,0 +1,324 @@
+#include <CTclVector.h>
+
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+namespace CTclVector {
+
+static void freeIntRepProc  (Tcl_Obj *obj);
+static void dupIntRepProc   (Tcl_Obj *srcObj, Tcl_Obj *dupObj);
+static void updateStringProc(Tcl_Obj *obj);
+static int  setFromAnyProc  (Tcl_Interp *interp, Tcl_Obj *obj);
+
+static Tcl_ObjType s_vectorType = {
+  "vector",
+  freeIntRepProc,
+  dupIntRepProc,
+  updateStringProc,
+  setFromAnyProc
+};
+
+//---
+
+Vector::
+Vector(Type type, size_t n) :
+ type_(type)
+{
+  if      (type_ == Type::Real ) reals_ .resize(n);
+  else if (type_ == Type::Int64) ints_  .resize(n);
+  else if (type_ == Type::Float) floats_.resize(n);
+
+  shape_.push_back(int(n));
+}
+
+bool
+Vector::
+setShape(const Shape &shape)
+{
+  size_t n = 1;
+
+  for (const auto &d : shape) {
+    if (d < 0) return false;
+
+    n *= size_t(d);
+  }
+
+  if (shape.empty() || n != size())
+    return false;
+
+  shape_ = shape;
+
+  return true;
+}
+
+size_t
+Vector::
+size() const
+{
+  if      (type_ == Type::Real ) return reals_ .size();
+  else if (type_ == Type::Int64) return ints_  .size();
+  else                           return floats_.size();
+}
+
+double
+Vector::
+value(size_t i) const
+{
+  if      (type_ == Type::Real ) return reals_[i];
+  else if (type_ == Type::Int64) return double(ints_[i]);
+  else                           return double(floats_[i]);
+}
+
+void
+Vector::
+setValue(size_t i, double r)
+{
+  if      (type_ == Type::Real ) reals_ [i] = r;
+  else if (type_ == Type::Int64) ints_  [i] = int64_t(r);
+  else                           floats_[i] = float(r);
+}
+
+Vector *
+Vector::
+slice(size_t start, size_t end, size_t step) const
+{
+  size_t n = size();
+
+  end   = std::min(end, n);
+  start = std::min(start, end);
+  step  = std::max(step, size_t(1));
+
+  size_t n1 = (end - start + step - 1)/step;
+
+  auto *vector = new Vector(type_, n1);
+
+  size_t j = 0;
+
+  for (size_t i = start; i < end; i += step, ++j) {
+    if      (type_ == Type::Real ) vector->reals_ [j] = reals_ [i];
+    else if (type_ == Type::Int64) vector->ints_  [j] = ints_  [i];
+    else                           vector->floats_[j] = floats_[i];
+  }
+
+  return vector;
+}
+
+Vector *
+Vector::
+convert(Type type) const
+{
+  size_t n = size();
+
+  auto *vector = new Vector(type, n);
+
+  for (size_t i = 0; i < n; ++i)
+    vector->setValue(i, value(i));
+
+  vector->shape_ = shape_;
+
+  return vector;
+}
+
+//---
+
+template<typename T>
+static double reduceValues(const T *values, size_t n, Reduce op)
+{
+  if (n == 0)
+    return 0.0;
+
+  if (op == Reduce::Min)
+    return double(*std::min_element(values, values + n));
+
+  if (op == Reduce::Max)
+    return double(*std::max_element(values, values + n));
+
+  double sum = 0.0;
+
+  for (size_t i = 0; i < n; ++i)
+    sum += double(values[i]);
+
+  if (op == Reduce::Mean)
+    return sum/double(n);
+
+  return sum;
+}
+
+double
+reduce(const Vector *vector, Reduce op)
+{
+  size_t n = vector->size();
+
+  if      (vector->type() == Type::Real ) return reduceValues(vector->reals (), n, op);
+  else if (vector->type() == Type::Int64) return reduceValues(vector->ints  (), n, op);
+  else                                    return reduceValues(vector->floats(), n, op);
+}
+
+//---
+
+void
+registerType()
+{
+  static bool registered = false;
+
+  if (! registered) {
+    Tcl_RegisterObjType(&s_vectorType);
+
+    registered = true;
+  }
+}
+
+const Tcl_ObjType *
+objType()
+{
+  return &s_vectorType;
+}
+
+bool
+isVector(Tcl_Obj *obj)
+{
+  return (obj && obj->typePtr == &s_vectorType);
+}
+
+Tcl_Obj *
+newObj(Vector *vector)
+{
+  auto *obj = Tcl_NewObj();
+
+  // string rep generated on demand
+  Tcl_InvalidateStringRep(obj);
+
+  vector->incRef();
+
+  obj->internalRep.twoPtrValue.ptr1 = vector;
+  obj->typePtr                      = &s_vectorType;
+
+  return obj;
+}
+
+Vector *
+getVector(Tcl_Interp *interp, Tcl_Obj *obj)
+{
+  if (! isVector(obj)) {
+    if (Tcl_ConvertToType(interp, obj, &s_vectorType) != TCL_OK)
+      return nullptr;
+  }
+
+  return static_cast<Vector *>(obj->internalRep.twoPtrValue.ptr1);
+}
+
+const char *
+typeName(Type type)
+{
+  if      (type == Type::Real ) return "real";
+  else if (type == Type::Int64) return "int64";
+  else                          return "float";
+}
+
+bool
+nameToType(const char *name, Type &type)
+{
+  if      (strcmp(name, "real" ) == 0 || strcmp(name, "double") == 0) type = Type::Real;
+  else if (strcmp(name, "int64") == 0 || strcmp(name, "int"   ) == 0) type = Type::Int64;
+  else if (strcmp(name, "float") == 0)                                type = Type::Float;
+  else return false;
+
+  return true;
+}
+
+//---
+
+static void
+freeIntRepProc(Tcl_Obj *obj)
+{
+  auto *vector = static_cast<Vector *>(obj->internalRep.twoPtrValue.ptr1);
+
+  vector->decRef();
+
+  obj->typePtr = nullptr;
+}
+
+static void
+dupIntRepProc(Tcl_Obj *srcObj, Tcl_Obj *dupObj)
+{
+  // share immutable vector
+  auto *vector = static_cast<Vector *>(srcObj->internalRep.twoPtrValue.ptr1);
+
+  vector->incRef();
+
+  dupObj->internalRep.twoPtrValue.ptr1 = vector;
+  dupObj->typePtr                      = &s_vectorType;
+}
+
+static void
+updateStringProc(Tcl_Obj *obj)
+{
+  // flat list of values (shape is not part of string rep)
+  auto *vector = static_cast<Vector *>(obj->internalRep.twoPtrValue.ptr1);
+
+  size_t n = vector->size();
+
+  std::string str;
+
+  char buffer[TCL_DOUBLE_SPACE + 1];
+
+  for (size_t i = 0; i < n; ++i) {
+    if (i > 0)
+      str += ' ';
+
+    if (vector->type() == Type::Int64)
+      snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(vector->ints()[i]));
+    else
+      Tcl_PrintDouble(nullptr, vector->value(i), buffer);
+
+    str += buffer;
+  }
+
+  obj->bytes = Tcl_Alloc((unsigned int) (str.size() + 1));
+
+  memcpy(obj->bytes, str.c_str(), str.size() + 1);
+
+  obj->length = int(str.size());
+}
+
+static int
+setFromAnyProc(Tcl_Interp *interp, Tcl_Obj *obj)
+{
+  // convert list of numbers to real vector
+  int       n    = 0;
+  Tcl_Obj **objs = nullptr;
+
+  if (Tcl_ListObjGetElements(interp, obj, &n, &objs) != TCL_OK)
+    return TCL_ERROR;
+
+  auto *vector = new Vector(Type::Real, size_t(n));
+
+  vector->incRef();
+
+  for (int i = 0; i < n; ++i) {
+    double r;
+
+    if (Tcl_GetDoubleFromObj(interp, objs[i], &r) != TCL_OK) {
+      vector->decRef();
+      return TCL_ERROR;
+    }
+
+    vector->setValue(size_t(i), r);
+  }
+
+  // keep string rep before releasing list rep
+  (void) Tcl_GetString(obj);
+
+  if (obj->typePtr && obj->typePtr->freeIntRepProc)
+    obj->typePtr->freeIntRepProc(obj);
+
+  obj->internalRep.twoPtrValue.ptr1 = vector;
+  obj->typePtr                      = &s_vectorType;
+
+  return TCL_OK;
+}
+
+}
@@ -0,0 +1,577 @@
+#include <CQTclCmd.h>
+#include <CQTclUtil.h>
+#include <CArgs.h>
+
+#include <tcl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+// micro benchmarks for CQTclCmd command argument handling and Qt/Tcl strings
+//
+// -args  : option resolution and parse cost per command call
+// -lists : split/merge throughput of large lists (UTF-8 bridge vs Latin-1 copies)
+class CQTclCmdTest {
+ public:
+  CQTclCmdTest();
+ ~CQTclCmdTest();
+
+  int iterations() const { return iterations_; }
+  void setIterations(int i) { iterations_ = std::max(i, 1); }
+
+  int listSize() const { return listSize_; }
+  void setListSize(int n) { listSize_ = std::max(n, 1); }
+
+  void benchArgs();
+
+  void benchLists();
+
+ private:
+  using Objs = std::vector<Tcl_Obj *>;
+
+  static void addArgs(CQTclCmd::CmdArgs &argv);
+
+  void makeObjs(const std::vector<std::string> &strs, Objs &objs) const;
+  void freeObjs(Objs &objs) const;
+
+  void printResult(const std::string &name, double seconds, double refSeconds) const;
+
+  void printListResult(const std::string &name, qint64 elements, qint64 bytes,
+                       double seconds, double refSeconds, bool roundTrip) const;
+
+ private:
+  Tcl_Interp* interp_     { nullptr };
+  int         iterations_ { 100000 };
+  int         listSize_   { 100000 };
+  double      sum_        { 0.0 };   //!< accumulated values (keeps loops live)
+};
+
+//---
+
+// replica of the parse path before CmdSchema (the baseline for -args speedups):
+// arguments converted to variants and strings per call, options found by linear
+// scan of the command args and values stored in option name keyed maps
+class CQTclCmdLegacyArgs {
+ public:
+  using CmdArgArray = std::vector<CQTclCmd::CmdArg>;
+
+  CQTclCmdLegacyArgs(Tcl_Interp *interp, const CmdArgArray &cmdArgs,
+                     int objc, const Tcl_Obj **objv) :
+   cmdArgs_(cmdArgs) {
+    for (int i = 0; i < objc; ++i)
+      argv_.push_back(CQTclUtil::variantFromObj(interp, objv[i]));
+  }
+
+  bool parse() {
+    parseInt_ .clear();
+    parseReal_.clear();
+    parseStr_ .clear();
+    parseBool_.clear();
+
+    std::map<int, std::set<QString>> groupNames;
+
+    for (size_t i = 0; i < argv_.size(); ) {
+      QString str = CQTclCmd::CmdArgs::toString(argv_[i++]);
+
+      if (! str.length() || str[0] != '-')
+        continue;
+
+      QString opt = str.mid(1);
+
+      const CQTclCmd::CmdArg *cmdArg = nullptr;
+
+      for (const auto &cmdArg1 : cmdArgs_) {
+        if (cmdArg1.isOpt() && cmdArg1.name() == opt) {
+          cmdArg = &cmdArg1;
+          break;
+        }
+      }
+
+      if (! cmdArg)
+        return false;
+
+      if (cmdArg->groupInd() >= 0)
+        groupNames[cmdArg->groupInd()].insert(cmdArg->name());
+
+      using Type = CQTclCmd::CmdArg::Type;
+
+      if (cmdArg->type() == int(Type::Boolean)) {
+        parseBool_[opt] = true;
+        continue;
+      }
+
+      if (i >= argv_.size())
+        return false;
+
+      QString value = CQTclCmd::CmdArgs::toString(argv_[i++]);
+
+      bool ok = true;
+
+      if      (cmdArg->type() == int(Type::Integer))
+        parseInt_[opt] = value.toInt(&ok);
+      else if (cmdArg->type() == int(Type::Real))
+        parseReal_[opt] = value.toDouble(&ok);
+      else if (cmdArg->type() == int(Type::SBool))
+        parseBool_[opt] = CQTclCmd::CmdArgs::stringToBool(value, &ok);
+      else
+        parseStr_[opt].push_back(value);
+
+      if (! ok)
+        return false;
+    }
+
+    return true;
+  }
+
+  int getParseInt(const QString &name) const {
+    auto p = parseInt_.find(name);
+    return (p != parseInt_.end() ? (*p).second : 0);
+  }
+
+  double getParseReal(const QString &name) const {
+    auto p = parseReal_.find(name);
+    return (p != parseReal_.end() ? (*p).second : 0.0);
+  }
+
+  QString getParseStr(const QString &name) const {
+    auto p = parseStr_.find(name);
+    return (p != parseStr_.end() && ! (*p).second.empty() ? (*p).second[0] : QString());
+  }
+
+  bool getParseBool(const QString &name) const {
+    auto p = parseBool_.find(name);
+    return (p != parseBool_.end() ? (*p).second : false);
+  }
+
+ private:
+  const CmdArgArray&             cmdArgs_;   //!< command args (linear scan)
+  std::vector<QVariant>          argv_;      //!< call args
+  std::map<QString, int>         parseInt_;  //!< parsed integer values
+  std::map<QString, double>      parseReal_; //!< parsed real values
+  std::map<QString, QStringList> parseStr_;  //!< parsed string values
+  std::map<QString, bool>        parseBool_; //!< parsed bool values
+};
+
+//---
+
+static std::string opts = "\
+-args:f \
+-lists:f \
+-iterations:i \
+-size:i \
+";
+
+int
+main(int argc, char **argv)
+{
+  CArgs cargs(opts);
+
+  cargs.parse(&argc, argv);
+
+  CQTclCmdTest test;
+
+  if (cargs.isIntegerArgSet("-iterations"))
+    test.setIterations(cargs.getIntegerArg("-iterations"));
+
+  if (cargs.isIntegerArgSet("-size"))
+    test.setListSize(cargs.getIntegerArg("-size"));
+
+  // all benchmarks if none specified
+  bool all = ! cargs.getBooleanArg("-args") && ! cargs.getBooleanArg("-lists");
+
+  if (all || cargs.getBooleanArg("-args"))
+    test.benchArgs();
+
+  if (all || cargs.getBooleanArg("-lists"))
+    test.benchLists();
+
+  return 0;
+}
+
+//---
+
+CQTclCmdTest::
+CQTclCmdTest()
+{
+  interp_ = Tcl_CreateInterp();
+}
+
+CQTclCmdTest::
+~CQTclCmdTest()
+{
+  Tcl_DeleteInterp(interp_);
+}
+
+void
+CQTclCmdTest::
+addArgs(CQTclCmd::CmdArgs &argv)
+{
+  // typical drawing command options
+  using Type = CQTclCmd::CmdArg::Type;
+
+  argv.addCmdArg("-path"           , int(Type::String ), "path");
+  argv.addCmdArg("-pixel"          , int(Type::Object ), "pixel");
+  argv.addCmdArg("-pixels"         , int(Type::Object ), "pixels");
+  argv.addCmdArg("-points"         , int(Type::Object ), "points");
+  argv.addCmdArg("-polyline"       , int(Type::Object ), "polyline");
+  argv.addCmdArg("-rects"          , int(Type::Object ), "rects");
+  argv.addCmdArg("-markers"        , int(Type::Object ), "markers");
+  argv.addCmdArg("-colors"         , int(Type::String ), "colors");
+  argv.addCmdArg("-symbol"         , int(Type::String ), "symbol");
+  argv.addCmdArg("-size"           , int(Type::Real   ), "size");
+  argv.addCmdArg("-fill"           , int(Type::String ), "fill");
+  argv.addCmdArg("-stroke"         , int(Type::String ), "stroke");
+  argv.addCmdArg("-mapping"        , int(Type::SBool  ), "mapping");
+  argv.addCmdArg("-pixel_to_window", int(Type::Object ), "pixel to window");
+  argv.addCmdArg("-window_to_pixel", int(Type::Object ), "window to pixel");
+  argv.addCmdArg("-count"          , int(Type::Integer), "count");
+  argv.addCmdArg("-invalidate"     , int(Type::Boolean), "invalidate");
+}
+
+void
+CQTclCmdTest::
+benchArgs()
+{
+  Objs objs;
+
+  makeObjs({"cmd", "-fill", "{color red}", "-stroke", "{width 2}", "-size", "5.5",
+            "-count", "10", "-symbol", "circle", "-invalidate"}, objs);
+
+  int         objc = int(objs.size()) - 1;
+  const auto *objv = const_cast<const Tcl_Obj **>(&objs[1]);
+
+  using Clock = std::chrono::steady_clock;
+
+  auto elapsed = [](const Clock::time_point &t1) {
+    return std::chrono::duration<double>(Clock::now() - t1).count();
+  };
+
+  //---
+
+  // schema built once (as for command procs), used by all variants below
+  CQTclCmd::CmdArgs schemaArgs("cmd", CQTclCmd::CmdArgs::Args());
+
+  addArgs(schemaArgs);
+
+  auto schema =
+    std::make_shared<const CQTclCmd::CmdSchema>(schemaArgs.cmdArgs(), schemaArgs.cmdGroups());
+
+  //---
+
+  // old parse path: variant args, linear option scan, name keyed value maps
+  auto t1 = Clock::now();
+
+  for (int i = 0; i < iterations(); ++i) {
+    CQTclCmdLegacyArgs argv(interp_, schema->cmdArgs(), objc, objv);
+
+    (void) argv.parse();
+
+    sum_ += argv.getParseStr ("fill"  ).length() + argv.getParseStr("stroke").length() +
+            argv.getParseReal("size"  ) + argv.getParseInt("count") +
+            argv.getParseStr ("symbol").length() + argv.getParseBool("invalidate");
+  }
+
+  double legacyTime = elapsed(t1);
+
+  //---
+
+  // arguments added and schema built every call (new parse path)
+  t1 = Clock::now();
+
+  for (int i = 0; i < iterations(); ++i) {
+    CQTclCmd::CmdArgs argv("cmd", interp_, objc, objv);
+
+    addArgs(argv);
+
+    auto schema = std::make_shared<const CQTclCmd::CmdSchema>(argv.cmdArgs(), argv.cmdGroups());
+
+    argv.setSchema(schema);
+
+    (void) argv.parse();
+
+    sum_ += argv.getParseStr ("fill"  ).length() + argv.getParseStr("stroke").length() +
+            argv.getParseReal("size"  ) + argv.getParseInt("count") +
+            argv.getParseStr ("symbol").length() + argv.getParseBool("invalidate");
+  }
+
+  double rebuildTime = elapsed(t1);
+
+  //---
+
+  // schema built once, values got by name
+  t1 = Clock::now();
+
+  for (int i = 0; i < iterations(); ++i) {
+    CQTclCmd::CmdArgs argv("cmd", interp_, objc, objv);
+
+    argv.setSchema(schema);
+
+    (void) argv.parse();
+
+    sum_ += argv.getParseStr ("fill"  ).length() + argv.getParseStr("stroke").length() +
+            argv.getParseReal("size"  ) + argv.getParseInt("count") +
+            argv.getParseStr ("symbol").length() + argv.getParseBool("invalidate");
+  }
+
+  double nameTime = elapsed(t1);
+
+  //---
+
+  // schema built once, values got by slot (slots looked up once)
+  int fillSlot       = schema->optSlot("fill");
+  int strokeSlot     = schema->optSlot("stroke");
+  int sizeSlot       = schema->optSlot("size");
+  int countSlot      = schema->optSlot("count");
+  int symbolSlot     = schema->optSlot("symbol");
+  int invalidateSlot = schema->optSlot("invalidate");
+
+  t1 = Clock::now();
+
+  for (int i = 0; i < iterations(); ++i) {
+    CQTclCmd::CmdArgs argv("cmd", interp_, objc, objv);
+
+    argv.setSchema(schema);
+
+    (void) argv.parse();
+
+    sum_ += argv.getSlotStr (fillSlot  ).length() + argv.getSlotStr(strokeSlot).length() +
+            argv.getSlotReal(sizeSlot  ) + argv.getSlotInt(countSlot) +
+            argv.getSlotStr (symbolSlot).length() + argv.getSlotBool(invalidateSlot);
+  }
+
+  double slotTime = elapsed(t1);
+
+  //---
+
+  // option name lookup only: linear scan with string compare vs schema hash
+  const auto &cmdArgs = schema->cmdArgs();
+
+  QStringList names = { "fill", "stroke", "size", "count", "symbol", "invalidate" };
+
+  t1 = Clock::now();
+
+  for (int i = 0; i < iterations(); ++i) {
+    for (const auto &name : names) {
+      int slot = 0;
+
+      for (const auto &cmdArg : cmdArgs) {
+        if (cmdArg.isOpt() && cmdArg.name() == name)
+          break;
+
+        ++slot;
+      }
+
+      sum_ += slot;
+    }
+  }
+
+  double scanTime = elapsed(t1);
+
+  t1 = Clock::now();
+
+  for (int i = 0; i < iterations(); ++i) {
+    for (const auto &name : names)
+      sum_ += schema->optSlot(name);
+  }
+
+  double hashTime = elapsed(t1);
+
+  //---
+
+  printResult("args_legacy" , legacyTime , legacyTime);
+  printResult("args_rebuild", rebuildTime, legacyTime);
+  printResult("args_name"   , nameTime   , legacyTime);
+  printResult("args_slot"   , slotTime   , legacyTime);
+  printResult("lookup_scan" , scanTime   , scanTime);
+  printResult("lookup_hash" , hashTime   , scanTime);
+
+  freeObjs(objs);
+}
+
+void
+CQTclCmdTest::
+benchLists()
+{
+  // list elements with spaces, braces and non Latin-1 chars
+  QStringList strs;
+
+  for (int i = 0; i < listSize(); ++i) {
+    auto num = QString::number(i);
+
+    if      (i % 3 == 0) strs << "item_" + num;
+    else if (i % 3 == 1) strs << "two words {" + num + "}";
+    else                 strs << QString::fromUtf8("\u00e9l\u00e9ment_\u4e2d\u6587_") + num;
+  }
+
+  int n = std::max(iterations()/10000, 1);
+
+  using Clock = std::chrono::steady_clock;
+
+  auto elapsed = [](const Clock::time_point &t1) {
+    return std::chrono::duration<double>(Clock::now() - t1).count();
+  };
+
+  //---
+
+  // merge: Latin-1 copy of each element plus strdup for Tcl_Merge (previous conversion)
+  QString legacyStr;
+
+  auto t1 = Clock::now();
+
+  for (int k = 0; k < n; ++k) {
+    std::vector<char *> argv(size_t(strs.size()));
+
+    for (int i = 0; i < strs.size(); ++i)
+      argv[size_t(i)] = strdup(strs[i].toLatin1().constData());
+
+    char *res = Tcl_Merge(int(argv.size()), &argv[0]);
+
+    legacyStr = QString(res);
+
+    Tcl_Free(res);
+
+    for (auto *arg : argv)
+      free(arg);
+  }
+
+  double legacyMergeTime = elapsed(t1);
+
+  // merge: single UTF-8 encode per element into list object
+  QString mergeStr;
+
+  t1 = Clock::now();
+
+  for (int k = 0; k < n; ++k)
+    mergeStr = CQTclUtil::mergeList(strs);
+
+  double mergeTime = elapsed(t1);
+
+  //---
+
+  // split: Latin-1 copy plus Tcl_SplitList (previous conversion)
+  QStringList legacyStrs;
+
+  t1 = Clock::now();
+
+  for (int k = 0; k < n; ++k) {
+    legacyStrs.clear();
+
+    QByteArray cstr = mergeStr.toLatin1();
+
+    int          argc;
+    const char **argv;
+
+    if (Tcl_SplitList(nullptr, cstr.constData(), &argc, &argv) != TCL_OK)
+      break;
+
+    for (int i = 0; i < argc; ++i)
+      legacyStrs << QString::fromLatin1(argv[i]);
+
+    Tcl_Free(reinterpret_cast<char *>(argv));
+  }
+
+  double legacySplitTime = elapsed(t1);
+
+  // split: list object elements decoded once
+  QStringList splitStrs;
+
+  t1 = Clock::now();
+
+  for (int k = 0; k < n; ++k) {
+    splitStrs.clear();
+
+    (void) CQTclUtil::splitList(mergeStr, splitStrs);
+  }
+
+  double splitTime = elapsed(t1);
+
+  //---
+
+  qint64 elements = qint64(n)*strs.size();
+  qint64 bytes    = qint64(n)*mergeStr.toUtf8().size();
+
+  QStringList legacyMergeStrs;
+
+  (void) CQTclUtil::splitList(legacyStr, legacyMergeStrs);
+
+  printListResult("merge_latin1", elements, bytes, legacyMergeTime, legacyMergeTime,
+                  legacyMergeStrs == strs);
+  printListResult("merge_utf8"  , elements, bytes, mergeTime      , legacyMergeTime,
+                  mergeStr == CQTclUtil::mergeList(splitStrs));
+  printListResult("split_latin1", elements, bytes, legacySplitTime, legacySplitTime,
+                  legacyStrs == strs);
+  printListResult("split_utf8"  , elements, bytes, splitTime      , legacySplitTime,
+                  splitStrs == strs);
+}
+
+void
+CQTclCmdTest::
+makeObjs(const std::vector<std::string> &strs, Objs &objs) const
+{
+  for (const auto &str : strs) {
+    auto *obj = Tcl_NewStringObj(str.c_str(), int(str.size()));
+
+    Tcl_IncrRefCount(obj);
+
+    objs.push_back(obj);
+  }
+}
+
+void
+CQTclCmdTest::
+freeObjs(Objs &objs) const
+{
+  for (auto *obj : objs)
+    Tcl_DecrRefCount(obj);
+
+  objs.clear();
+}
+
+void
+CQTclCmdTest::
+printResult(const std::string &name, double seconds, double refSeconds) const
+{
+  // one JSON object per line (speedup relative to reference)
+  char buffer[256];
+
+  snprintf(buffer, sizeof(buffer),
+           "{\"name\": \"%s\", \"iterations\": %d, \"seconds\": %.6f, "
+           "\"ns_per_call\": %.1f, \"speedup\": %.2f}",
+           name.c_str(), iterations(), seconds, 1E9*seconds/iterations(),
+           seconds > 0.0 ? refSeconds/seconds : 0.0);
+
+  std::cout << buffer << "\n";
+
+  // (print sum so compiler keeps loops)
+  if (sum_ < 0.0)
+    std::cerr << sum_ << "\n";
+}
+
+void
+CQTclCmdTest::
+printListResult(const std::string &name, qint64 elements, qint64 bytes, double seconds,
+                double refSeconds, bool roundTrip) const
+{
+  // one JSON object per line (round_trip false if text was corrupted)
+  double sec = std::max(seconds, 1E-9);
+
+  char buffer[512];
+
+  snprintf(buffer, sizeof(buffer),
+           "{\"name\": \"%s\", \"elements\": %d, \"bytes\": %lld, \"seconds\": %.6f, "
+           "\"mb_per_s\": %.3f, \"elements_per_s\": %.0f, \"speedup\": %.2f, "
+           "\"round_trip\": %s}",
+           name.c_str(), listSize(), static_cast<long long>(bytes), seconds,
+           double(bytes)/(1024.0*1024.0)/sec, double(elements)/sec, refSeconds/sec,
+           roundTrip ? "true" : "false");
+
+  std::cout << buffer << "\n";
+}
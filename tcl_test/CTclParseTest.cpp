@@ -1,7 +1,44 @@
 #include <CTclParse.h>
+#include <CTclIncrParse.h>
+#include <CTclScan.h>
 #include <CArgs.h>
 #include <CReadLine.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+//---
+
+// count heap allocations (for benchmark allocations per KB)
+static std::atomic<long> s_numAllocs { 0 };
+
+void *operator new(std::size_t size)
+{
+  ++s_numAllocs;
+
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+//---
+
 class CTclParseTest {
  public:
   CTclParseTest();
@@ -15,8 +52,20 @@ class CTclParseTest {
   bool isTest() const { return test_; }
   void setTest(bool b) { test_ = b; }
 
+  int iterations() const { return iterations_; }
+  void setIterations(int i) { iterations_ = std::max(i, 1); }
+
+  void setNumThreads(int n) { tcl_->setNumThreads(n); }
+
+  const std::string &benchFile() const { return benchFile_; }
+  void setBenchFile(const std::string &s) { benchFile_ = s; }
+
   void parseFile(const std::string &filename);
 
+  void bench(const std::vector<std::string> &filenames);
+
+  bool randomTest(int numInputs, unsigned int seed);
+
   void mainLoop();
 
  private:
@@ -29,12 +78,45 @@ class CTclParseTest {
 
   bool readLine(std::string &line);
 
+  struct BenchResult {
+    std::string name;
+    long        bytes      { 0 };
+    long        tokens     { 0 };
+    long        allocs     { 0 };
+    double      seconds    { 0.0 };
+    long        peakRss    { 0 };
+    bool        peakReset  { false }; //!< peakRss is for this input only
+    bool        rc         { true };
+  };
+
+  void benchInput(const std::string &name, const std::string &filename, BenchResult &result);
+
+  static bool writeTempFile(const std::string &str, std::string &filename);
+
+  static bool resetPeakRss();
+  static long peakRss();
+
+  static long countTokens(const CTclToken::Tokens &tokens);
+  static long countTokens(CTclToken *token);
+
+  static void stressInputs(std::vector<std::pair<std::string, std::string>> &inputs);
+
+  static std::string randomText(std::mt19937 &rand, int maxLen);
+  static std::string randomScript(std::mt19937 &rand, int depth);
+
+  static bool refIsComplete(const std::string &str);
+
+  static std::string dumpTokens(const CTclToken::Tokens &tokens, int start, int end);
+  static void dumpToken(std::ostream &os, CTclToken *token, int offset);
+
  private:
-  bool       debug_    { false };
-  bool       tokens_   { false };
-  bool       test_     { false };
-  CTclParse *tcl_      { nullptr };
-  CReadLine *readline_ { nullptr };
+  bool        debug_      { false };
+  bool        tokens_     { false };
+  bool        test_       { false };
+  int         iterations_ { 10 };
+  std::string benchFile_;
+  CTclParse*  tcl_        { nullptr };
+  CReadLine*  readline_   { nullptr };
 };
 
 //---
@@ -43,6 +125,12 @@ static std::string opts = "\
 -tokens:f \
 -debug:f \
 -test:f \
+-bench:f \
+-iterations:i \
+-threads:i \
+-output:s \
+-random:i \
+-seed:i \
 ";
 
 int
@@ -55,6 +143,7 @@ main(int argc, char **argv)
   bool debug  = false;
   bool tokens = false;
   bool test   = false;
+  bool bench  = false;
 
   if (cargs.getBooleanArg("-debug"))
     debug = true;
@@ -65,13 +154,44 @@ main(int argc, char **argv)
   if (cargs.getBooleanArg("-test"))
     test = true;
 
+  if (cargs.getBooleanArg("-bench"))
+    bench = true;
+
   CTclParseTest parseTest;
 
   parseTest.setDebug (debug);
   parseTest.setTokens(tokens);
   parseTest.setTest  (test);
 
-  if (argc > 1)
+  if (cargs.isIntegerArgSet("-iterations"))
+    parseTest.setIterations(cargs.getIntegerArg("-iterations"));
+
+  if (cargs.isIntegerArgSet("-threads"))
+    parseTest.setNumThreads(cargs.getIntegerArg("-threads"));
+
+  if (cargs.isStringArgSet("-output"))
+    parseTest.setBenchFile(cargs.getStringArg("-output"));
+
+  if      (cargs.isIntegerArgSet("-random")) {
+    // randomized equivalence checks (exit code 1 on mismatch)
+    unsigned int seed = 1;
+
+    if (cargs.isIntegerArgSet("-seed"))
+      seed = (unsigned int) cargs.getIntegerArg("-seed");
+
+    if (! parseTest.randomTest(cargs.getIntegerArg("-random"), seed))
+      return 1;
+  }
+  else if (bench) {
+    // files (if any) plus generated stress inputs
+    std::vector<std::string> filenames;
+
+    for (int i = 1; i < argc; ++i)
+      filenames.push_back(argv[i]);
+
+    parseTest.bench(filenames);
+  }
+  else if (argc > 1)
     parseTest.parseFile(argv[1]);
   else
     parseTest.mainLoop();
@@ -333,3 +453,512 @@ readLine(std::string &line)
 
   return true;
 }
+
+//---
+
+void
+CTclParseTest::
+bench(const std::vector<std::string> &filenames)
+{
+  std::vector<BenchResult> results;
+
+  for (const auto &filename : filenames) {
+    BenchResult result;
+
+    benchInput(filename, filename, result);
+
+    results.push_back(result);
+  }
+
+  // generated inputs are parsed from temporary files (same path and threads as files)
+  std::vector<std::pair<std::string, std::string>> inputs;
+
+  stressInputs(inputs);
+
+  for (const auto &input : inputs) {
+    std::string filename;
+
+    if (! writeTempFile(input.second, filename)) {
+      std::cerr << "Failed to write temporary file for '" << input.first << "'\n";
+      continue;
+    }
+
+    BenchResult result;
+
+    benchInput(input.first, filename, result);
+
+    results.push_back(result);
+
+    unlink(filename.c_str());
+  }
+
+  //---
+
+  // one JSON object per line
+  std::ofstream file;
+
+  if (benchFile() != "") {
+    file.open(benchFile());
+
+    if (! file.is_open()) {
+      std::cerr << "Failed to open '" << benchFile() << "'\n";
+      return;
+    }
+  }
+
+  std::ostream &os = (file.is_open() ? static_cast<std::ostream &>(file) : std::cout);
+
+  for (const auto &result : results) {
+    double mb  = double(result.bytes)*iterations()/(1024.0*1024.0);
+    double kb  = double(result.bytes)*iterations()/1024.0;
+    double sec = std::max(result.seconds, 1E-9);
+
+    char buffer[512];
+
+    snprintf(buffer, sizeof(buffer),
+             "{\"name\": \"%s\", \"bytes\": %ld, \"iterations\": %d, "
+             "\"threads\": %d, \"simd\": \"%s\", \"ok\": %s, \"tokens\": %ld, "
+             "\"seconds\": %.6f, \"mb_per_s\": %.3f, \"tokens_per_s\": %.0f, "
+             "\"allocs_per_kb\": %.3f, \"peak_rss_kb\": %ld, \"peak_rss_reset\": %s}",
+             result.name.c_str(), result.bytes, iterations(), tcl_->numThreads(),
+             CTclScan::simdName(), result.rc ? "true" : "false", result.tokens,
+             result.seconds, mb/sec, double(result.tokens)*iterations()/sec,
+             kb > 0.0 ? double(result.allocs)/kb : 0.0, result.peakRss,
+             result.peakReset ? "true" : "false");
+
+    os << buffer << "\n";
+  }
+}
+
+void
+CTclParseTest::
+benchInput(const std::string &name, const std::string &filename, BenchResult &result)
+{
+  // name is json string so replace chars needing escape
+  result.name = name;
+
+  for (auto &c : result.name)
+    if (c == '\"' || c == '\\' || iscntrl(c))
+      c = '_';
+
+  auto parse = [&](CTclToken::Tokens &tokens) {
+    tokens.clear();
+
+    return tcl_->parseFile(filename, tokens);
+  };
+
+  // peak resident set size during this input only if reset supported (includes
+  // memory still held at reset)
+  result.peakReset = resetPeakRss();
+
+  CTclToken::Tokens tokens;
+
+  // warm up (page cache, arena blocks)
+  result.rc = parse(tokens);
+
+  result.bytes  = long(tcl_->arena().source().size());
+  result.tokens = countTokens(tokens);
+
+  long numAllocs = s_numAllocs;
+
+  auto t1 = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < iterations(); ++i)
+    result.rc = (parse(tokens) && result.rc);
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  result.seconds = std::chrono::duration<double>(t2 - t1).count();
+  result.allocs  = s_numAllocs - numAllocs;
+
+  result.peakRss = peakRss();
+}
+
+bool
+CTclParseTest::
+resetPeakRss()
+{
+  // linux: writing 5 to clear_refs resets peak resident set size (VmHWM)
+  std::ofstream file("/proc/self/clear_refs");
+
+  if (! file.is_open())
+    return false;
+
+  file << "5";
+
+  file.close();
+
+  return ! file.fail();
+}
+
+long
+CTclParseTest::
+peakRss()
+{
+  // peak resident set size (kB) from VmHWM (reset by resetPeakRss), process
+  // peak (ru_maxrss, never reset) if not available
+  std::ifstream file("/proc/self/status");
+
+  std::string line;
+
+  while (std::getline(file, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::atol(line.c_str() + 6);
+  }
+
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  return long(usage.ru_maxrss);
+}
+
+bool
+CTclParseTest::
+writeTempFile(const std::string &str, std::string &filename)
+{
+  char path[] = "/tmp/CTclParseTestXXXXXX";
+
+  int fd = mkstemp(path);
+
+  if (fd < 0)
+    return false;
+
+  filename = path;
+
+  size_t pos = 0;
+
+  while (pos < str.size()) {
+    auto n = write(fd, str.data() + pos, str.size() - pos);
+
+    if (n <= 0) {
+      close(fd);
+
+      unlink(path);
+
+      return false;
+    }
+
+    pos += size_t(n);
+  }
+
+  close(fd);
+
+  return true;
+}
+
+long
+CTclParseTest::
+countTokens(const CTclToken::Tokens &tokens)
+{
+  long n = 0;
+
+  for (const auto &token : tokens)
+    n += countTokens(token);
+
+  return n;
+}
+
+long
+CTclParseTest::
+countTokens(CTclToken *token)
+{
+  long n = 1;
+
+  for (const auto &token1 : token->tokens())
+    n += countTokens(token1);
+
+  return n;
+}
+
+void
+CTclParseTest::
+stressInputs(std::vector<std::pair<std::string, std::string>> &inputs)
+{
+  // deep nesting of command substitutions and braces
+  std::string nest;
+
+  int depth = 200;
+
+  for (int i = 0; i < depth; ++i)
+    nest += "set v" + std::to_string(i) + " [list {a $b} ";
+
+  nest += "x";
+
+  for (int i = 0; i < depth; ++i)
+    nest += "]";
+
+  nest += "\n";
+
+  inputs.emplace_back("gen:deep_nesting", nest);
+
+  // long double quoted string with variables, substitutions and escapes
+  std::string quoted = "set s \"";
+
+  for (int i = 0; i < 20000; ++i)
+    quoted += "word $v(" + std::to_string(i) + ") [incr n] \\t\\\"text\\\" ";
+
+  quoted += "\"\n";
+
+  inputs.emplace_back("gen:long_quoted", quoted);
+
+  // huge brace body (proc body with many commands)
+  std::string body = "proc p { a b } {\n";
+
+  for (int i = 0; i < 50000; ++i)
+    body += "  if {$a > " + std::to_string(i) + "} { set b [expr {$b + $a}] }\n";
+
+  body += "}\n";
+
+  inputs.emplace_back("gen:huge_brace", body);
+
+  // many short commands (typical script)
+  std::string script;
+
+  for (int i = 0; i < 50000; ++i)
+    script += "set x" + std::to_string(i % 100) + " \"$y [foo $i]\" ; puts $x\n";
+
+  inputs.emplace_back("gen:many_commands", script);
+}
+
+//---
+
+bool
+CTclParseTest::
+randomTest(int numInputs, unsigned int seed)
+{
+  // randomized equivalence checks of fast paths against reference implementations:
+  //  . token index vs linear getTokenForPos at every position
+  //  . incremental parse (after random edits) vs fresh scan and full parse
+  //  . CTclScan::isComplete vs scalar reference
+  std::mt19937 rand(seed);
+
+  // syntax errors of random text are expected
+  std::ostringstream errStream;
+
+  auto *errBuf = std::cerr.rdbuf(errStream.rdbuf());
+
+  int numErrors = 0;
+
+  auto error = [&](const std::string &check, const std::string &str) {
+    if (++numErrors > 10)
+      return;
+
+    std::cout << "Mismatch (" << check << ") for '" << str << "'\n";
+  };
+
+  CTclIncrParse incrParse;
+  bool          wellFormed { true };
+
+  for (int k = 0; k < numInputs; ++k) {
+    errStream.str("");
+
+    auto str = randomText(rand, 200);
+
+    // token index vs linear search
+    CTclToken::Tokens tokens;
+
+    (void) tcl_->parseString(str, tokens);
+
+    const auto &index = tcl_->tokenIndex();
+
+    for (int pos = -1; pos <= int(str.size()); ++pos) {
+      if (index.tokenForPos(pos) != tcl_->getTokenForPos(tokens, pos)) {
+        error("index pos " + std::to_string(pos), str);
+        break;
+      }
+    }
+
+    // complete vs reference
+    if (CTclScan::isComplete(str.data(), str.size()) != refIsComplete(str))
+      error("isComplete", str);
+
+    //---
+
+    // random edit of incremental parse text. Raw edits check the scan only (quotes
+    // inside words are literal to the parser but pair in the scan) and scripts
+    // inserted at command boundaries keep text well formed for the token check
+    const auto &text = incrParse.text();
+
+    if (text.size() > 400 || (! wellFormed && rand() % 8 == 0)) {
+      incrParse.setText(randomScript(rand, 2));
+
+      wellFormed = true;
+    }
+    else if (rand() % 4 == 0) {
+      int pos = std::uniform_int_distribution<int>(0, int(text.size()))(rand);
+
+      incrParse.replace(pos, int(rand() % 8), randomText(rand, 8));
+
+      wellFormed = false;
+    }
+    else {
+      int pos = std::uniform_int_distribution<int>(0, int(text.size()))(rand);
+
+      int start, end;
+
+      incrParse.commandRange(pos, start, end);
+
+      incrParse.insert(rand() % 2 ? start : end, randomScript(rand, 2) + "\n");
+    }
+
+    // command split and completeness vs fresh scan of whole text
+    CTclIncrParse freshParse;
+
+    freshParse.setText(text);
+
+    bool same = (incrParse.numCommands() == freshParse.numCommands() &&
+                 incrParse.isComplete () == freshParse.isComplete ());
+
+    for (int i = 0; same && i <= int(text.size()); ++i) {
+      int start1, end1, start2, end2;
+
+      incrParse .commandRange(i, start1, end1);
+      freshParse.commandRange(i, start2, end2);
+
+      same = (start1 == start2 && end1 == end2);
+    }
+
+    if (! same)
+      error("incremental scan", text);
+
+    // tokens of command at random position vs full parse of complete text
+    if (! same || ! wellFormed || ! incrParse.isComplete())
+      continue;
+
+    int qpos = std::uniform_int_distribution<int>(0, int(text.size()))(rand);
+
+    int start, end;
+
+    const auto &ctokens = incrParse.commandTokens(qpos, start, end);
+
+    auto cstr = dumpTokens(ctokens, 0, end - start);
+
+    CTclToken::Tokens ftokens;
+
+    if (! tcl_->parseString(text, ftokens))
+      continue;
+
+    auto fstr = dumpTokens(ftokens, start, end);
+
+    if (cstr != fstr)
+      error("incremental tokens", text);
+  }
+
+  std::cerr.rdbuf(errBuf);
+
+  std::cout << numInputs << " random inputs (seed " << seed << "), " <<
+               numErrors << " mismatches\n";
+
+  return (numErrors == 0);
+}
+
+std::string
+CTclParseTest::
+randomText(std::mt19937 &rand, int maxLen)
+{
+  // mostly structural chars so nesting, escapes and command ends are common
+  static const std::string chars = "ab1 -$[]{}\"';\\\n\t#()";
+
+  int len = std::uniform_int_distribution<int>(0, maxLen)(rand);
+
+  std::uniform_int_distribution<int> charDist(0, int(chars.size()) - 1);
+
+  std::string str;
+
+  for (int i = 0; i < len; ++i)
+    str += chars[size_t(charDist(rand))];
+
+  return str;
+}
+
+std::string
+CTclParseTest::
+randomScript(std::mt19937 &rand, int depth)
+{
+  // words of names, variables, escapes and balanced nested groups
+  std::string str;
+
+  int numWords = int(rand() % 6);
+
+  for (int i = 0; i < numWords; ++i) {
+    if (i > 0) {
+      int sep = int(rand() % 8);
+
+      str += (sep == 0 ? "\n" : sep == 1 ? "; " : " ");
+    }
+
+    int type = int(rand() % (depth > 0 ? 9 : 5));
+
+    switch (type) {
+      case 0 : str += "set"; break;
+      case 1 : str += "-opt"; break;
+      case 2 : str += "$v" + std::to_string(rand() % 3); break;
+      case 3 : str += "${a b}"; break;
+      case 4 : str += "\\x"; break;
+      case 5 : str += "{" + randomScript(rand, depth - 1) + "}"; break;
+      case 6 : str += "[" + randomScript(rand, depth - 1) + "]"; break;
+      case 7 : str += "\"" + randomScript(rand, 0) + "\""; break;
+      default: str += "a(" + randomScript(rand, 0) + ")"; break;
+    }
+  }
+
+  return str;
+}
+
+bool
+CTclParseTest::
+refIsComplete(const std::string &str)
+{
+  // char by char nesting (escaped char skipped)
+  std::string endChars;
+
+  for (size_t i = 0; i < str.size(); ++i) {
+    char c = str[i];
+
+    if      (c == '[')
+      endChars.push_back(']');
+    else if (c == '{')
+      endChars.push_back('}');
+    else if (! endChars.empty() && c == endChars.back())
+      endChars.pop_back();
+    else if (c == '\"' || c == '\'')
+      endChars.push_back(c);
+    else if (c == '\\')
+      ++i;
+  }
+
+  return endChars.empty();
+}
+
+std::string
+CTclParseTest::
+dumpTokens(const CTclToken::Tokens &tokens, int start, int end)
+{
+  // top level tokens in range with positions relative to start
+  std::ostringstream os;
+
+  for (const auto &token : tokens) {
+    if (token->pos() >= start && token->pos() < end)
+      dumpToken(os, token, start);
+  }
+
+  return os.str();
+}
+
+void
+CTclParseTest::
+dumpToken(std::ostream &os, CTclToken *token, int offset)
+{
+  os << CTclToken::typeName(token->type()) << ":" << token->str() << "@" <<
+        token->pos() - offset;
+
+  if (! token->tokens().empty()) {
+    os << '[';
+
+    for (const auto &token1 : token->tokens())
+      dumpToken(os, token1, offset);
+
+    os << ']';
+  }
+}